@@ -0,0 +1,40 @@
+//
+//  AdmissionQueue.cpp
+//  CloudSim
+//
+
+#include <algorithm>
+
+#include "AdmissionQueue.hpp"
+#include "SchedulerContext.hpp"
+
+void AdmissionQueue::Push(TaskId_t task_id) {
+    const TaskPlacementAttrs_t & task = Task_GetPlacementAttrs(task_id);
+    pending.insert(make_tuple(task.target_completion, task.sla, task_id));
+}
+
+void AdmissionQueue::Drain(Time_t time) {
+    if(draining) {
+        return;
+    }
+    draining = true;
+    released = false;
+    // Tasks the policy still cannot place keep their position, the next drain starts behind them
+    size_t batch = min(pending.size(), size_t(ADMISSION_BATCH));
+    auto it = pending.lower_bound(resume);
+    for(size_t offered = 0; offered < batch; offered++) {
+        if(it == pending.end()) {
+            it = pending.begin();
+        }
+        TaskId_t task_id = get<2>(*it);
+        CurrentContext->policy->new_task(time, task_id);
+        if(CurrentScheduler().index.TaskVM(task_id) != NO_VM) {
+            it = pending.erase(it);
+        }
+        else {
+            ++it;
+        }
+    }
+    resume = it != pending.end() ? *it : AdmissionKey_t();
+    draining = false;
+}
@@ -0,0 +1,43 @@
+//
+//  AdmissionQueue.hpp
+//  CloudSim
+//
+//  Tasks that the policy could not place when they arrived, ordered by deadline and then by SLA class.
+//  HandleNewTask() queues a task when the policy leaves it without a VM, and the hooks that free capacity offer
+//  the queue back to the policy in batches. Each batch resumes after the tasks the previous one offered and wraps
+//  around at the end, so tasks stuck at the head cannot starve the ones behind them. StateChangeComplete() and
+//  MigrationDone() drain right away.
+//  HandleTaskCompletion() runs while the simulator is still removing the task from its machine, so it only marks
+//  the queue and the next SchedulerCheck() drains it. Without the queue the simulator waits forever on the tasks
+//  that were never placed.
+//
+
+#ifndef AdmissionQueue_hpp
+#define AdmissionQueue_hpp
+
+#include <set>
+#include <tuple>
+
+#include "Interfaces.h"
+
+#define ADMISSION_BATCH     16      // Most tasks offered to the policy per drain
+
+typedef tuple<Time_t, SLAType_t, TaskId_t> AdmissionKey_t;        // (target completion, SLA, task)
+
+class AdmissionQueue {
+public:
+    AdmissionQueue()            {}
+    void Clear()                                { pending.clear(); resume = AdmissionKey_t(); released = false; draining = false; }
+    void Push(TaskId_t task_id);
+    void Drain(Time_t time);                    // Offers up to ADMISSION_BATCH tasks in deadline order from resume
+    void Release()                              { released = !pending.empty(); }
+    void DrainReleased(Time_t time)             { if(released) { Drain(time); } }
+    size_t Size() const                         { return pending.size(); }
+private:
+    set<AdmissionKey_t> pending;
+    AdmissionKey_t resume;                      // First task the next drain offers, or the one after it
+    bool released = false;                      // Capacity was freed since the last drain
+    bool draining = false;                      // Waking a machine can call back into StateChangeComplete()
+};
+
+#endif /* AdmissionQueue_hpp */
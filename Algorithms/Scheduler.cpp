@@ -0,0 +1,170 @@
+//
+//  Scheduler.cpp
+//  CloudSim
+//
+//  Created by ELMOOTAZBELLAH ELNOZAHY on 10/20/24.
+//
+
+#include <algorithm>
+
+#include "SchedulerContext.hpp"
+
+class GreedyScheduler : public Scheduler {
+public:
+    void Init();
+    void MigrationComplete(Time_t time, VMId_t vm_id);
+    void NewTask(Time_t now, TaskId_t task_id);
+    void NewTasks(Time_t now, const TaskId_t * task_ids, unsigned count);
+    void PeriodicCheck(Time_t now);
+    void Shutdown(Time_t now);
+    void StateChangeComplete(Time_t time, MachineId_t machine_id);
+    void TaskComplete(Time_t now, TaskId_t task_id);
+private:
+    vector<TaskId_t> batch;     // Reused by NewTasks()
+};
+
+static unsigned GetMachineUtilization(MachineId_t machine_id) {
+    return CurrentScheduler().index.MachineTasks(machine_id);
+}
+void GreedyScheduler::Init() {
+    // Find the parameters of the clusters
+    // Get the total number of machines
+    // For each machine:
+    //      Get the type of the machine
+    //      Get the memory of the machine
+    //      Get the number of CPUs
+    //      Get if there is a GPU or not
+    //
+    SIM_LOG("Scheduler::Init(): Total number of machines is " + to_string(Machine_GetTotal()), 3);
+    SIM_LOG("Scheduler::Init(): Initializing scheduler", 1);
+    unsigned total_machines = Machine_GetTotal();
+    index.Init(total_machines);
+    MachineView_Init();
+    TaskView_Init();
+    for(unsigned i = 0; i < total_machines; i++) {
+        MachineId_t machine_id = MachineId_t(i);
+        machines.push_back(machine_id);
+
+        // MachineInfo_t info = Machine_GetInfo(machine_id);
+        // MachineState_t s_state = info.s_state;
+        // if (s_state != S5) {
+        //     unsigned num_cpus = info.num_cpus;
+        //     unsigned mem_size = info.memory_size;
+        //     bool gpu = info.gpus;
+        //     CPUType_t cpu = info.cpu;
+        // }
+
+    }
+    capacity.Init(machines);
+}
+
+void GreedyScheduler::MigrationComplete(Time_t time, VMId_t vm_id) {
+    // Update your data structure. The VM now can receive new tasks
+    MachineId_t source = index.CompleteMigration(vm_id);
+    MachineId_t destination = index.VMMachine(vm_id);
+    MachineView_Invalidate(source);
+    capacity.Update(source);
+    MachineView_Invalidate(destination);
+    capacity.Update(destination);
+}
+
+void GreedyScheduler::NewTask(Time_t now, TaskId_t task_id) {
+    // Greedy Algorithm
+
+    TaskPlacementAttrs_t task_attrs = Task_GetPlacementAttrs(task_id);
+    bool task_gpu_capable = task_attrs.gpu_capable;
+    unsigned task_memory = task_attrs.memory;
+    VMType_t task_vm_type = task_attrs.vm_type;
+    SLAType_t task_sla = task_attrs.sla;
+    CPUType_t task_cpu = task_attrs.cpu;
+
+    // Only visit compatible machines with enough free memory, in machine order
+    CapacityRequest_t request = {task_cpu, task_memory + VM_MEMORY_OVERHEAD, false, false};
+    for (MachineId_t machine_id = capacity.FirstFit(request); machine_id != NO_MACHINE;
+         machine_id = capacity.FirstFit(request, machine_id)) {
+        //Getting machine info
+        const MachineView_t & machine_info = Machine_GetView(machine_id);
+
+        //make sure machine is awake
+        Traced_MachineSetState(machine_id, S0);
+
+        //calculate the things
+        unsigned machine_utilization = GetMachineUtilization(machine_id);
+        float memory_utilization = (float) machine_info.memory_used / machine_info.memory_size;
+        float task_load_factor = (float) (task_memory + VM_MEMORY_OVERHEAD) / machine_info.memory_size;
+
+        if (machine_utilization + 1 < machine_info.num_cpus * 50 && memory_utilization + task_load_factor < 1.0) {
+            VMId_t vm_id = Traced_VMCreate(task_vm_type, task_cpu);
+            vms.push_back(vm_id);
+            Traced_VMAttach(vm_id, machine_id);
+            Traced_VMAddTask(vm_id, task_id, MID_PRIORITY);
+            index.AttachVM(vm_id, machine_id);
+            index.AddTask(vm_id, task_id);
+            MachineView_Invalidate(machine_id);
+            capacity.Update(machine_id);
+            return;
+        } 
+    }
+    // SLA VIOLATION! :(
+}
+
+void GreedyScheduler::NewTasks(Time_t now, const TaskId_t * task_ids, unsigned count) {
+    // First fit decreasing, the largest tasks of a burst pick their machines first
+    batch.assign(task_ids, task_ids + count);
+    sort(batch.begin(), batch.end(), [](TaskId_t a, TaskId_t b) {
+        unsigned memory = Task_GetPlacementAttrs(a).memory;
+        unsigned other = Task_GetPlacementAttrs(b).memory;
+        return memory != other ? memory > other : a < b;
+    });
+    for(TaskId_t task_id : batch) {
+        NewTask(now, task_id);
+    }
+}
+
+void GreedyScheduler::PeriodicCheck(Time_t now) {
+    // This method should be called from SchedulerCheck()
+    // SchedulerCheck is called periodically by the simulator to allow you to monitor, make decisions, adjustments, etc.
+    // Unlike the other invocations of the scheduler, this one doesn't report any specific event
+    // Recommendation: Take advantage of this function to do some monitoring and adjustments as necessary
+}
+
+void GreedyScheduler::Shutdown(Time_t time) {
+    // Do your final reporting and bookkeeping here.
+    // Report about the total energy consumed
+    // Report about the SLA compliance
+    // Shutdown everything to be tidy :-)
+    for(auto & vm: vms) {
+        Traced_VMShutdown(vm);
+    }
+    index.Clear();
+    SIM_LOG("SimulationComplete(): Finished!", 4);
+    SIM_LOG("SimulationComplete(): Time is " + to_string(time), 4);
+}
+
+void GreedyScheduler::TaskComplete(Time_t now, TaskId_t task_id) {
+    // The simulator has already removed the task from its VM, so look the VM up in the index
+    VMId_t vm_id = index.RemoveTask(task_id);
+    MachineId_t machine_id = index.VMMachine(vm_id);
+
+    // Check if task is found
+    if (vm_id == NO_VM || machine_id == NO_MACHINE) {
+        return;
+    }
+    vms.erase(find(vms.begin(), vms.end(), vm_id));
+
+    SIM_LOG("Scheduler::TaskComplete(): Task " + to_string(task_id) + " is complete at " + to_string(now), 4);
+
+    Traced_VMShutdown(vm_id);
+    index.DetachVM(vm_id);
+    MachineView_Invalidate(machine_id);
+    capacity.Update(machine_id);
+    SIM_LOG("VM " + to_string(vm_id) + " shut down.", 4);
+}
+
+void GreedyScheduler::StateChangeComplete(Time_t time, MachineId_t machine_id) {
+    // Called in response to an earlier request to change the state of a machine
+    MachineView_Invalidate(machine_id);
+    capacity.Update(machine_id);
+}
+
+const SchedulerPolicy_t GreedyPolicy = PolicyHooks<GreedyScheduler>::Describe("greedy", NO_PERIODIC_CHECK, PolicyHooks<GreedyScheduler>::NewTasks);
@@ -6,28 +6,39 @@
 //
 // P-MAPPER ALGORITHM
 
-#include "Scheduler.hpp"
+#include "SchedulerContext.hpp"
 #include <algorithm>
 #include <limits>
 
-static Scheduler s;
-static bool migrating = false;
-static unsigned active_machines = 16;
-unsigned GetMachineUtilization(MachineId_t machine_id) {
-    unsigned utilization = 0;
-    for (VMId_t vm_id : s.vms) {
-        VMInfo_t vm_info = VM_GetInfo(vm_id);
-        if (vm_info.machine_id == machine_id) {
-            utilization += vm_info.active_tasks.size();
-        }
+class PMapperScheduler : public Scheduler {
+public:
+    void Init();
+    void MigrationComplete(Time_t time, VMId_t vm_id);
+    void NewTask(Time_t now, TaskId_t task_id);
+    void PeriodicCheck(Time_t now);
+    void Shutdown(Time_t now);
+    void StateChangeComplete(Time_t time, MachineId_t machine_id);
+    void TaskComplete(Time_t now, TaskId_t task_id);
+};
+
+static unsigned GetMachineUtilization(MachineId_t machine_id) {
+    return CurrentScheduler().index.MachineTasks(machine_id);
+}
+// The scan woke every compatible machine it passed, including those without enough free memory
+static void WakeSkippedMachines(CPUType_t cpu, MachineId_t after, MachineId_t before) {
+    CapacityIndex & capacity = CurrentScheduler().capacity;
+    for (MachineId_t machine_id = capacity.FirstAsleep(cpu, after, before); machine_id != NO_MACHINE;
+         machine_id = capacity.FirstAsleep(cpu, machine_id, before)) {
+        Traced_MachineSetState(machine_id, S0);
+        MachineView_Invalidate(machine_id);
+        capacity.Update(machine_id);
     }
-    return utilization;
 }
-bool SortMachines(MachineId_t a, MachineId_t b) {
-    return Machine_GetInfo(a).memory_size < Machine_GetInfo(b).memory_size;
+static bool SortMachines(MachineId_t a, MachineId_t b) {
+    return Machine_GetMemorySize(a) < Machine_GetMemorySize(b);
 }
 
-void Scheduler::Init() {
+void PMapperScheduler::Init() {
     // Find the parameters of the clusters
     // Get the total number of machines
     // For each machine:
@@ -36,84 +47,106 @@ void Scheduler::Init() {
     //      Get the number of CPUs
     //      Get if there is a GPU or not
     //
-    SimOutput("Scheduler::Init(): Total number of machines is " + to_string(Machine_GetTotal()), 3);
-    SimOutput("Scheduler::Init(): Initializing scheduler", 1);
+    SIM_LOG("Scheduler::Init(): Total number of machines is " + to_string(Machine_GetTotal()), 3);
+    SIM_LOG("Scheduler::Init(): Initializing scheduler", 1);
     unsigned total_machines = Machine_GetTotal();
+    index.Init(total_machines);
+    MachineView_Init();
+    TaskView_Init();
     for(unsigned i = 0; i < total_machines; i++) {
         MachineId_t machine_id = MachineId_t(i);
         machines.push_back(machine_id);
     }
     // Sort machines by energy consumption
     std::sort(machines.begin(), machines.end(), SortMachines);
+    capacity.Init(machines);
 }
 
-void Scheduler::MigrationComplete(Time_t time, VMId_t vm_id) {
+void PMapperScheduler::MigrationComplete(Time_t time, VMId_t vm_id) {
     // Update your data structure. The VM now can receive new tasks
+    MachineId_t source = index.CompleteMigration(vm_id);
+    MachineId_t destination = index.VMMachine(vm_id);
+    MachineView_Invalidate(source);
+    capacity.Update(source);
+    MachineView_Invalidate(destination);
+    capacity.Update(destination);
 }
 
-void Scheduler::NewTask(Time_t now, TaskId_t task_id) {
+void PMapperScheduler::NewTask(Time_t now, TaskId_t task_id) {
     // P-Mapper algorithm
 
-    bool task_gpu_capable = IsTaskGPUCapable(task_id);
-    unsigned task_memory = GetTaskMemory(task_id);
-    VMType_t task_vm_type = RequiredVMType(task_id);
-    SLAType_t task_sla = RequiredSLA(task_id);
-    CPUType_t task_cpu = RequiredCPUType(task_id);
-
-    unsigned total_machines = Machine_GetTotal();
-    for (unsigned i = 0; i < total_machines; i++) {
-        MachineId_t machine_id = machines[i];
-        MachineInfo_t machine_info = Machine_GetInfo(machine_id);
-        if (task_cpu != machine_info.cpu) {
-            continue;
-        }
+    TaskPlacementAttrs_t task_attrs = Task_GetPlacementAttrs(task_id);
+    bool task_gpu_capable = task_attrs.gpu_capable;
+    unsigned task_memory = task_attrs.memory;
+    VMType_t task_vm_type = task_attrs.vm_type;
+    SLAType_t task_sla = task_attrs.sla;
+    CPUType_t task_cpu = task_attrs.cpu;
+
+    // Only visit compatible machines with enough free memory, smallest first
+    CapacityRequest_t request = {task_cpu, task_memory + VM_MEMORY_OVERHEAD, false, false};
+    MachineId_t scanned = NO_MACHINE;
+    for (MachineId_t machine_id = capacity.FirstFit(request); machine_id != NO_MACHINE;
+         machine_id = capacity.FirstFit(request, machine_id)) {
+        WakeSkippedMachines(task_cpu, scanned, machine_id);
+        scanned = machine_id;
+        const MachineView_t & machine_info = Machine_GetView(machine_id);
         if (machine_info.s_state != S0) {
-           Machine_SetState(machine_id, S0);
+           Traced_MachineSetState(machine_id, S0);
+           MachineView_Invalidate(machine_id);
+           capacity.Update(machine_id);
         }
         unsigned machine_utilization = GetMachineUtilization(machine_id);
         float memory_utilization = (float) machine_info.memory_used / machine_info.memory_size;
         float task_load_factor = (float) (task_memory + VM_MEMORY_OVERHEAD) / machine_info.memory_size;
 
         if (machine_utilization + 1 < machine_info.num_cpus * 50 && memory_utilization + task_load_factor < 1.0) {
-            VMId_t vm_id = VM_Create(task_vm_type, task_cpu);
+            VMId_t vm_id = Traced_VMCreate(task_vm_type, task_cpu);
             vms.push_back(vm_id);
-            VM_Attach(vm_id, machine_id);
-            VM_AddTask(vm_id, task_id, MID_PRIORITY);
+            Traced_VMAttach(vm_id, machine_id);
+            Traced_VMAddTask(vm_id, task_id, MID_PRIORITY);
+            index.AttachVM(vm_id, machine_id);
+            index.AddTask(vm_id, task_id);
+            MachineView_Invalidate(machine_id);
+            capacity.Update(machine_id);
             return;
         }
     }
+    WakeSkippedMachines(task_cpu, scanned, NO_MACHINE);
 
     // Turn off unused machines
     for (MachineId_t machine_id : machines) {
-        MachineInfo_t machine_info = Machine_GetInfo(machine_id);
+        const MachineView_t & machine_info = Machine_GetView(machine_id);
         float machine_utilization = (float) machine_info.memory_used / machine_info.memory_size;
         if (machine_info.s_state != S5 && machine_utilization == 0.0) {
-            Machine_SetState(machine_id, S5);
+            Traced_MachineSetState(machine_id, S5);
+            MachineView_Invalidate(machine_id);
+            capacity.Update(machine_id);
         }
     }
 }
 
-void Scheduler::PeriodicCheck(Time_t now) {
+void PMapperScheduler::PeriodicCheck(Time_t now) {
 
 }
 
-void Scheduler::Shutdown(Time_t time) {
+void PMapperScheduler::Shutdown(Time_t time) {
     // Do your final reporting and bookkeeping here.
     // Report about the total energy consumed
     // Report about the SLA compliance
     // Shutdown everything to be tidy :-)
     for(auto & vm: vms) {
-        VM_Shutdown(vm);
+        Traced_VMShutdown(vm);
     }
-    SimOutput("SimulationComplete(): Finished!", 4);
-    SimOutput("SimulationComplete(): Time is " + to_string(time), 4);
+    index.Clear();
+    SIM_LOG("SimulationComplete(): Finished!", 4);
+    SIM_LOG("SimulationComplete(): Time is " + to_string(time), 4);
 }
 
 static MachineId_t GetLeastUtilizedMachine() {
     float min_utilization = 100.0;
-    MachineId_t least_utilized_machine;
-    for (auto machine_id : s.machines) {
-        MachineInfo_t machine_info = Machine_GetInfo(machine_id);
+    MachineId_t least_utilized_machine = NO_MACHINE;
+    for (auto machine_id : CurrentScheduler().machines) {
+        const MachineView_t & machine_info = Machine_GetView(machine_id);
         float machine_utilization = (float) machine_info.memory_used / machine_info.memory_size;
         if (machine_utilization < min_utilization) {
             least_utilized_machine = machine_id;
@@ -122,114 +155,61 @@ static MachineId_t GetLeastUtilizedMachine() {
     return least_utilized_machine;
 }
 
-unsigned GetTotalTaskMemoryForVM(VMInfo_t vm) {
-    unsigned total = 0;
-    for (TaskId_t task_id : vm.active_tasks) {
-        TaskInfo_t task_info = GetTaskInfo(task_id);
-        total += task_info.required_memory;
-    }
-    return total;
+static unsigned GetTotalTaskMemoryForVM(VMId_t vm_id) {
+    return Task_GetTotalMemory(VM_GetTasks(vm_id));
 }
 
 static VMId_t GetSmallestWorkload(MachineId_t machine_id) {
     unsigned min_workload = 4294967295;
     VMId_t smallest_workload = -1;
-    for (VMId_t vm_id : s.vms) {
-        VMInfo_t vm_info = VM_GetInfo(vm_id);
-        unsigned vm_total_task_memory = GetTotalTaskMemoryForVM(vm_info);
-        if (vm_info.machine_id == machine_id &&
-            vm_total_task_memory < min_workload) {
+    for (VMId_t vm_id : CurrentScheduler().index.MachineVMs(machine_id)) {
+        unsigned vm_total_task_memory = GetTotalTaskMemoryForVM(vm_id);
+        if (vm_total_task_memory < min_workload) {
             smallest_workload = vm_id;
         }
     }
     return smallest_workload;
 }
 
-void Scheduler::TaskComplete(Time_t now, TaskId_t task_id) {
+void PMapperScheduler::TaskComplete(Time_t now, TaskId_t task_id) {
+    VMId_t vm_id = index.RemoveTask(task_id);
+    if (vm_id != NO_VM) {
+        MachineView_Invalidate(index.VMMachine(vm_id));
+        capacity.Update(index.VMMachine(vm_id));
+    }
     MachineId_t least_utilized_machine = GetLeastUtilizedMachine();
+    if (least_utilized_machine == NO_MACHINE) {
+        return;
+    }
     VMId_t smallest_workload_on_machine = GetSmallestWorkload(least_utilized_machine);
     if (smallest_workload_on_machine == -1) {
         return;
     }
-    VMInfo_t vm_info = VM_GetInfo(smallest_workload_on_machine);
-    unsigned num_machines = Machine_GetTotal();
-    for (int i = num_machines - 1; i >= 0; i--) {
-        MachineId_t machine_id = machines[i];
-        MachineInfo_t machine_info = Machine_GetInfo(machine_id);
-        if (vm_info.cpu != machine_info.cpu) {
-            continue;
-        }
+    CPUType_t vm_cpu = Machine_GetCPU(VM_GetMachine(smallest_workload_on_machine));
+    unsigned vm_memory = GetTotalTaskMemoryForVM(smallest_workload_on_machine);
+    // Largest awake machine that can take the VM
+    CapacityRequest_t request = {vm_cpu, vm_memory + VM_MEMORY_OVERHEAD, false, true};
+    for (MachineId_t machine_id = capacity.LastFit(request); machine_id != NO_MACHINE;
+         machine_id = capacity.LastFit(request, machine_id)) {
+        const MachineView_t & machine_info = Machine_GetView(machine_id);
         float machine_utilization = (float) machine_info.memory_used / machine_info.memory_size;
-        float task_load_factor = (float) (GetTotalTaskMemoryForVM(vm_info) + VM_MEMORY_OVERHEAD)
+        float task_load_factor = (float) (vm_memory + VM_MEMORY_OVERHEAD)
             / machine_info.memory_size;
         if (machine_utilization + task_load_factor < 1.0) {
-            if (machine_info.s_state == S0) {
-                VM_Migrate(smallest_workload_on_machine, machine_id);
-                return;
-            }
+            Traced_VMMigrate(smallest_workload_on_machine, machine_id);
+            index.StartMigration(smallest_workload_on_machine, machine_id);
+            MachineView_Invalidate(machine_id);
+            capacity.Update(machine_id);
+            return;
         }
     }
-    SimOutput("Scheduler::TaskComplete(): Task " + to_string(task_id) + " is complete at " + to_string(now), 4);
-}
-// Public interface below
-
-void InitScheduler() {
-    SimOutput("InitScheduler(): Initializing scheduler", 4);
-    s.Init();
-}
-
-void HandleNewTask(Time_t time, TaskId_t task_id) {
-    SimOutput("HandleNewTask(): Received new task " + to_string(task_id) + " at time " + to_string(time), 4);
-    s.NewTask(time, task_id);
-}
-
-void HandleTaskCompletion(Time_t time, TaskId_t task_id) {
-    SimOutput("HandleTaskCompletion(): Task " + to_string(task_id) + " completed at time " + to_string(time), 4);
-    s.TaskComplete(time, task_id);
-}
-
-void MemoryWarning(Time_t time, MachineId_t machine_id) {
-    // The simulator is alerting you that machine identified by machine_id is overcommitted
-    SimOutput("MemoryWarning(): Overflow at " + to_string(machine_id) + " was detected at time " + to_string(time), 0);
-}
-
-void MigrationDone(Time_t time, VMId_t vm_id) {
-    // The function is called on to alert you that migration is complete
-    SimOutput("MigrationDone(): Migration of VM " + to_string(vm_id) + " was completed at time " + to_string(time), 4);
-    s.MigrationComplete(time, vm_id);
-    migrating = false;
-}
-
-void SchedulerCheck(Time_t time) {
-    // This function is called periodically by the simulator, no specific event
-    SimOutput("SchedulerCheck(): SchedulerCheck() called at " + to_string(time), 4);
-    s.PeriodicCheck(time);
-    // static unsigned counts = 0;
-    // counts++;
-    // if(counts == 10) {
-    //     migrating = true;
-    //     VM_Migrate(1, 9);
-    // }
-}
-
-void SimulationComplete(Time_t time) {
-    // This function is called before the simulation terminates Add whatever you feel like.
-    cout << "SLA violation report" << endl;
-    cout << "SLA0: " << GetSLAReport(SLA0) << "%" << endl;
-    cout << "SLA1: " << GetSLAReport(SLA1) << "%" << endl;
-    cout << "SLA2: " << GetSLAReport(SLA2) << "%" << endl;     // SLA3 do not have SLA violation issues
-    cout << "Total Energy " << Machine_GetClusterEnergy() << "KW-Hour" << endl;
-    cout << "Simulation run finished in " << double(time)/1000000 << " seconds" << endl;
-    SimOutput("SimulationComplete(): Simulation finished at time " + to_string(time), 4);
-
-    s.Shutdown(time);
-}
-
-void SLAWarning(Time_t time, TaskId_t task_id) {
-
+    SIM_LOG("Scheduler::TaskComplete(): Task " + to_string(task_id) + " is complete at " + to_string(now), 4);
 }
 
-void StateChangeComplete(Time_t time, MachineId_t machine_id) {
+void PMapperScheduler::StateChangeComplete(Time_t time, MachineId_t machine_id) {
     // Called in response to an earlier request to change the state of a machine
+    MachineView_Invalidate(machine_id);
+    capacity.Update(machine_id);
 }
 
+const SchedulerPolicy_t PMapperPolicy = PolicyHooks<PMapperScheduler>::Describe("pmapper", NO_PERIODIC_CHECK);
@@ -0,0 +1,677 @@
+//
+//  SchedulerBench.cpp
+//  CloudSim
+//
+//  Synthetic driver for the scheduler callbacks. It stands in for the Machine, VM, Task and Simulator modules
+//  behind Interfaces.h, replays a stream of arrivals and completions against a generated cluster and reports
+//  the latency distribution and heap allocations of every callback. It links the scheduler sources and every
+//  policy in Algorithms/ the way the simulator does, see BENCH_SRC in the Makefile.
+//
+//  Each run owns its driver state and binds its own SchedulerContext, so -j runs that many seeds concurrently.
+//  -p picks the policy by its registry name, CLOUDSIM_POLICY is used otherwise.
+//
+//  -f time -n count forks count what-if continuations once the run reaches time (microseconds). The process is
+//  forked, so the continuations share the warmed-up cluster, scheduler state and event queue copy-on-write
+//  instead of replaying the prefix. Continuation i reseeds the arrivals that follow with seed + i.
+//
+//  -w window delivers arrivals that follow each other within window microseconds, with no other event between
+//  them, as one HandleNewTasks() call at the time of the last one. HandleNewTask latencies are then per burst.
+//
+//  usage: bench [-p policy] [-m machines] [-t tasks] [-u utilization] [-s seed] [-j runs] [-f time -n count] [-w window]
+//
+
+#include <algorithm>
+#include <chrono>
+#include <cstdarg>
+#include <cstdlib>
+#include <cstring>
+#include <new>
+#include <queue>
+#include <mutex>
+#include <random>
+#include <sstream>
+#include <thread>
+#include <sys/wait.h>
+#include <unistd.h>
+
+#include "Interfaces.h"
+#include "SchedulerContext.hpp"
+
+// Heap allocations are counted through the global operator new, the driver's own allocations are not
+static thread_local uint64_t Allocations = 0;
+static thread_local bool Counting = false;
+
+void * operator new(size_t size) {
+    if(Counting) {
+        Allocations++;
+    }
+    void * p = malloc(size ? size : 1);
+    if(p == nullptr) {
+        throw bad_alloc();
+    }
+    return p;
+}
+void operator delete(void * p) noexcept             { free(p); }
+void operator delete(void * p, size_t) noexcept     { free(p); }
+
+class Uncounted {
+public:
+    Uncounted()                 { saved = Counting; Counting = false; }
+    ~Uncounted()                { Counting = saved; }
+private:
+    bool saved;
+};
+
+// Cluster
+
+typedef struct {
+    unsigned num_cpus;
+    unsigned memory_size;
+    CPUType_t cpu;
+    bool gpus;
+    vector<unsigned> performance;
+    vector<unsigned> c_states;
+    vector<unsigned> p_states;
+    vector<unsigned> s_states;
+} BenchMachineClass_t;
+
+static const BenchMachineClass_t MachineClasses[] = {
+    {8,  16384, X86,   false, {3000, 2400, 2000, 1500}, {12, 3, 1, 0}, {12, 8, 6, 4},   {120, 100, 100, 80, 40, 10, 0}},
+    {4,  8192,  X86,   false, {1500, 1200, 1000, 600},  {4, 1, 1, 0},  {4, 2, 2, 1},    {40, 20, 16, 12, 10, 4, 0}},
+    {16, 32768, ARM,   true,  {2000, 1600, 1200, 800},  {8, 2, 1, 0},  {10, 7, 5, 3},   {200, 160, 160, 120, 60, 15, 0}},
+    {8,  16384, POWER, true,  {4000, 3200, 2400, 1600}, {16, 4, 2, 0}, {18, 12, 9, 6},  {250, 200, 200, 150, 80, 20, 0}},
+};
+#define MACHINE_CLASSES (sizeof(MachineClasses) / sizeof(MachineClasses[0]))
+
+typedef struct {
+    unsigned machine_class;
+    unsigned memory_used;
+    unsigned active_tasks;
+    unsigned active_vms;
+    MachineState_t s_state;
+    MachineState_t next_state;              // Applied when the pending state change completes
+    uint64_t energy;
+} BenchMachine_t;
+
+typedef struct {
+    VMType_t vm_type;
+    CPUType_t cpu;
+    MachineId_t machine_id;
+    MachineId_t destination;                // Machine the VM is migrating to, or the machine itself
+    vector<TaskId_t> tasks;
+} BenchVM_t;
+
+// Events
+
+typedef enum {
+    TASK_ARRIVAL,
+    TASK_COMPLETION,
+    MIGRATION_DONE,
+    STATE_CHANGE,
+    TIMER
+} BenchEventType_t;
+
+typedef struct {
+    Time_t time;
+    uint64_t sequence;
+    BenchEventType_t type;
+    unsigned id;
+} BenchEvent_t;
+
+struct BenchEventLater {
+    bool operator()(const BenchEvent_t & a, const BenchEvent_t & b) const {
+        return a.time != b.time ? a.time > b.time : a.sequence > b.sequence;
+    }
+};
+
+#define MIGRATION_LATENCY   10000       // Microseconds
+#define STATE_LATENCY       1000
+#define TIMER_PERIOD        100000
+#define MEAN_RUNTIME        2000000
+
+// Statistics
+
+typedef enum {
+    NEW_TASK,
+    TASK_COMPLETE,
+    MIGRATION_COMPLETE,
+    STATE_CHANGE_COMPLETE,
+    SCHEDULER_CHECK
+} Callback_t;
+#define CALLBACKS 5
+
+static const char * CallbackNames[CALLBACKS] = {
+    "HandleNewTask", "HandleTaskCompletion", "MigrationDone", "StateChangeComplete", "SchedulerCheck"
+};
+
+typedef struct {
+    vector<uint64_t> latency;               // Nanoseconds, one sample per call
+    uint64_t allocations;
+} CallbackStats_t;
+
+typedef struct {
+    vector<BenchMachine_t> machines;
+    vector<BenchVM_t> vms;
+    vector<TaskInfo_t> tasks;
+    vector<Time_t> runtimes;
+    vector<VMId_t> task_vms;                    // task -> VM running it, or -1
+    unsigned pending_tasks;                     // Tasks that have neither completed nor been dropped
+    double mean_interarrival;                   // Microseconds, meets the utilization on average
+    unsigned posted_arrivals;                   // Tasks whose arrival has been posted, one ahead of the clock
+    vector<TaskId_t> burst;                     // Arrivals delivered together with -w
+    priority_queue<BenchEvent_t, vector<BenchEvent_t>, BenchEventLater> events;
+    uint64_t sequence;
+    Time_t current_time;
+    CallbackStats_t stats[CALLBACKS];
+} BenchRun_t;
+
+static thread_local BenchRun_t * Run = nullptr;     // The run driven by this thread
+
+static void Post(Time_t time, BenchEventType_t type, unsigned id) {
+    Run->events.push({time, Run->sequence++, type, id});
+}
+
+template <typename F>
+static void Measure(Callback_t callback, F call) {
+    uint64_t allocations = Allocations;
+    Counting = true;
+    auto start = chrono::steady_clock::now();
+    call();
+    auto end = chrono::steady_clock::now();
+    Counting = false;
+    Run->stats[callback].allocations += Allocations - allocations;
+    Run->stats[callback].latency.push_back(chrono::duration_cast<chrono::nanoseconds>(end - start).count());
+}
+
+// printf() to cout, so the report follows cout when it is redirected
+static void Print(const char * format, ...) {
+    char line[256];
+    va_list args;
+    va_start(args, format);
+    vsnprintf(line, sizeof(line), format, args);
+    va_end(args);
+    cout << line;
+}
+
+static void Report(double wall_seconds, uint64_t events) {
+    Print("%-22s %10s %10s %10s %12s %12s\n", "callback", "calls", "p50 ns", "p99 ns", "max ns", "allocs/call");
+    for(unsigned i = 0; i < CALLBACKS; i++) {
+        vector<uint64_t> & latency = Run->stats[i].latency;
+        if(latency.empty()) {
+            Print("%-22s %10u\n", CallbackNames[i], 0);
+            continue;
+        }
+        sort(latency.begin(), latency.end());
+        Print("%-22s %10zu %10llu %10llu %12llu %12.2f\n", CallbackNames[i], latency.size(),
+               (unsigned long long) latency[latency.size() / 2],
+               (unsigned long long) latency[min(latency.size() - 1, latency.size() * 99 / 100)],
+               (unsigned long long) latency.back(),
+               double(Run->stats[i].allocations) / latency.size());
+    }
+    Print("%llu events in %.3f s, %.0f events/s\n", (unsigned long long) events, wall_seconds, events / wall_seconds);
+}
+
+// Debugging Interface
+
+void SimOutput(string msg, unsigned verbose_level) {
+}
+
+void ThrowException(string err_msg) {
+    throw runtime_error(err_msg);
+}
+
+void ThrowException(string err_msg, string further_input) {
+    throw runtime_error(err_msg + further_input);
+}
+
+void ThrowException(string err_msg, unsigned further_input) {
+    throw runtime_error(err_msg + to_string(further_input));
+}
+
+// Machine Interface
+
+CPUType_t Machine_GetCPUType(MachineId_t machine_id) {
+    return MachineClasses[Run->machines[machine_id].machine_class].cpu;
+}
+
+uint64_t Machine_GetEnergy(MachineId_t machine_id) {
+    return Run->machines[machine_id].energy;
+}
+
+double Machine_GetClusterEnergy() {
+    uint64_t total = 0;
+    for(auto & machine : Run->machines) {
+        total += machine.energy;
+    }
+    return double(total) / 3600 / 1000000 / 1000;
+}
+
+MachineInfo_t Machine_GetInfo(MachineId_t machine_id) {
+    const BenchMachine_t & machine = Run->machines[machine_id];
+    const BenchMachineClass_t & machine_class = MachineClasses[machine.machine_class];
+    MachineInfo_t info;
+    info.num_cpus = machine_class.num_cpus;
+    info.cpu = machine_class.cpu;
+    info.memory_size = machine_class.memory_size;
+    info.memory_used = machine.memory_used;
+    info.active_tasks = machine.active_tasks;
+    info.active_vms = machine.active_vms;
+    info.gpus = machine_class.gpus;
+    info.energy_consumed = machine.energy;
+    info.performance = machine_class.performance;
+    info.c_states = machine_class.c_states;
+    info.p_states = machine_class.p_states;
+    info.s_states = machine_class.s_states;
+    info.s_state = machine.s_state;
+    info.p_state = P0;
+    info.machine_id = machine_id;
+    return info;
+}
+
+unsigned Machine_GetTotal() {
+    return Run->machines.size();
+}
+
+void Machine_SetCorePerformance(MachineId_t machine_id, unsigned core_id, CPUPerformance_t p_state) {
+}
+
+void Machine_SetState(MachineId_t machine_id, MachineState_t s_state) {
+    Uncounted uncounted;
+    BenchMachine_t & machine = Run->machines[machine_id];
+    if(machine.next_state == s_state) {
+        return;
+    }
+    machine.next_state = s_state;
+    Post(Run->current_time + STATE_LATENCY, STATE_CHANGE, machine_id);
+}
+
+// Statistics
+
+double GetSLAReport(SLAType_t sla) {
+    unsigned total = 0, violated = 0;
+    for(auto & task : Run->tasks) {
+        if(task.completed && task.required_sla == sla) {
+            total++;
+            violated += task.completion > task.target_completion;
+        }
+    }
+    return total ? 100.0 * violated / total : 0.0;
+}
+
+// Simulator Interface
+
+Time_t Now() {
+    return Run->current_time;
+}
+
+// Task Interface
+
+unsigned GetNumTasks()                                      { return Run->tasks.size(); }
+TaskInfo_t GetTaskInfo(TaskId_t task_id)                    { return Run->tasks[task_id]; }
+unsigned GetTaskMemory(TaskId_t task_id)                    { return Run->tasks[task_id].required_memory; }
+unsigned GetTaskPriority(TaskId_t task_id)                  { return Run->tasks[task_id].priority; }
+bool IsSLAViolated(TaskId_t task_id)                        { return Run->tasks[task_id].completed && Run->tasks[task_id].completion > Run->tasks[task_id].target_completion; }
+bool IsTaskCompleted(TaskId_t task_id)                      { return Run->tasks[task_id].completed; }
+bool IsTaskGPUCapable(TaskId_t task_id)                     { return Run->tasks[task_id].gpu_capable; }
+CPUType_t RequiredCPUType(TaskId_t task_id)                 { return Run->tasks[task_id].required_cpu; }
+SLAType_t RequiredSLA(TaskId_t task_id)                     { return Run->tasks[task_id].required_sla; }
+VMType_t RequiredVMType(TaskId_t task_id)                   { return Run->tasks[task_id].required_vm; }
+void SetTaskPriority(TaskId_t task_id, Priority_t priority) { Run->tasks[task_id].priority = priority; }
+
+// Tasks that are never placed, or whose VM is shut down under them, count as violating their SLA
+static void DropTask(TaskId_t task_id) {
+    Run->task_vms[task_id] = VMId_t(-1);
+    Run->tasks[task_id].completed = true;
+    Run->tasks[task_id].completion = Time_t(-1);
+    Run->pending_tasks--;
+}
+
+// VM Interface, VM_GetMachine(), VM_GetTaskCount() and VM_GetTasks() come from SchedulerContext.cpp
+
+static void Charge(MachineId_t machine_id, int memory, int tasks) {
+    Run->machines[machine_id].memory_used += memory;
+    Run->machines[machine_id].active_tasks += tasks;
+}
+
+static void ChargeVM(const BenchVM_t & vm, int memory, int tasks) {
+    Charge(vm.machine_id, memory, tasks);
+    if(vm.destination != vm.machine_id) {
+        Charge(vm.destination, memory, tasks);
+    }
+}
+
+void VM_Attach(VMId_t vm_id, MachineId_t machine_id) {
+    BenchVM_t & vm = Run->vms[vm_id];
+    vm.machine_id = vm.destination = machine_id;
+    Run->machines[machine_id].active_vms++;
+    Charge(machine_id, VM_MEMORY_OVERHEAD, 0);
+}
+
+void VM_AddTask(VMId_t vm_id, TaskId_t task_id, Priority_t priority) {
+    Uncounted uncounted;
+    BenchVM_t & vm = Run->vms[vm_id];
+    vm.tasks.push_back(task_id);
+    Run->task_vms[task_id] = vm_id;
+    Run->tasks[task_id].priority = priority;
+    ChargeVM(vm, Run->tasks[task_id].required_memory, 1);
+    Post(Run->current_time + Run->runtimes[task_id], TASK_COMPLETION, task_id);
+}
+
+VMId_t VM_Create(VMType_t vm_type, CPUType_t cpu) {
+    Uncounted uncounted;
+    Run->vms.push_back({vm_type, cpu, MachineId_t(-1), MachineId_t(-1), vector<TaskId_t>()});
+    return Run->vms.size() - 1;
+}
+
+VMInfo_t VM_GetInfo(VMId_t vm_id) {
+    const BenchVM_t & vm = Run->vms[vm_id];
+    return {vm.tasks, vm.cpu, vm.machine_id, vm_id, vm.vm_type};
+}
+
+void VM_Migrate(VMId_t vm_id, MachineId_t machine_id) {
+    Uncounted uncounted;
+    BenchVM_t & vm = Run->vms[vm_id];
+    if(vm.destination != vm.machine_id || machine_id == vm.machine_id) {
+        ThrowException("VM_Migrate(): Incorrect VM migration request for VM ", vm_id);
+    }
+    unsigned memory = VM_MEMORY_OVERHEAD;
+    for(TaskId_t task_id : vm.tasks) {
+        memory += Run->tasks[task_id].required_memory;
+    }
+    vm.destination = machine_id;
+    Run->machines[machine_id].active_vms++;
+    Charge(machine_id, memory, vm.tasks.size());
+    Post(Run->current_time + MIGRATION_LATENCY, MIGRATION_DONE, vm_id);
+}
+
+void VM_RemoveTask(VMId_t vm_id, TaskId_t task_id) {
+    BenchVM_t & vm = Run->vms[vm_id];
+    auto it = find(vm.tasks.begin(), vm.tasks.end(), task_id);
+    if(it == vm.tasks.end()) {
+        ThrowException("VM_RemoveTask(): Task is not running on VM ", vm_id);
+    }
+    vm.tasks.erase(it);
+    Run->task_vms[task_id] = VMId_t(-1);
+    ChargeVM(vm, -int(Run->tasks[task_id].required_memory), -1);
+}
+
+void VM_Shutdown(VMId_t vm_id) {
+    BenchVM_t & vm = Run->vms[vm_id];
+    if(vm.machine_id == MachineId_t(-1)) {
+        return;
+    }
+    unsigned memory = VM_MEMORY_OVERHEAD;
+    for(TaskId_t task_id : vm.tasks) {
+        memory += Run->tasks[task_id].required_memory;
+    }
+    ChargeVM(vm, -int(memory), -int(vm.tasks.size()));
+    Run->machines[vm.machine_id].active_vms--;
+    if(vm.destination != vm.machine_id) {
+        Run->machines[vm.destination].active_vms--;
+    }
+    vm.machine_id = vm.destination = MachineId_t(-1);
+    for(TaskId_t task_id : vm.tasks) {
+        DropTask(task_id);
+    }
+    vm.tasks.clear();
+}
+
+// Driver
+
+static void AccountEnergy(Time_t elapsed) {
+    for(auto & machine : Run->machines) {
+        machine.energy += uint64_t(MachineClasses[machine.machine_class].s_states[machine.s_state]) * elapsed;
+    }
+}
+
+// Lays out the tasks from first on, their arrivals follow the one of task first - 1
+static void LayOutTasks(TaskId_t first, unsigned seed) {
+    static const unsigned memory_sizes[] = {8, 64, 256, 1024};
+    static const CPUType_t cpus[] = {X86, X86, ARM, POWER};
+    mt19937_64 rng(seed);
+    exponential_distribution<double> interarrival(1.0 / Run->mean_interarrival);
+    exponential_distribution<double> runtime(1.0 / MEAN_RUNTIME);
+    uniform_int_distribution<unsigned> pick(0, 3);
+    Time_t arrival = first ? Run->tasks[first - 1].arrival : 0;
+    for(TaskId_t task_id = first; task_id < Run->tasks.size(); task_id++) {
+        arrival += Time_t(interarrival(rng)) + 1;
+        Time_t task_runtime = Time_t(runtime(rng)) + 1;
+        TaskInfo_t task = {};
+        task.arrival = arrival;
+        task.target_completion = arrival + 2 * task_runtime;
+        task.required_cpu = cpus[pick(rng)];
+        task.gpu_capable = pick(rng) == 0;
+        task.required_memory = memory_sizes[pick(rng)];
+        task.required_sla = SLAType_t(pick(rng));
+        task.required_vm = LINUX;
+        task.priority = MID_PRIORITY;
+        task.task_id = task_id;
+        Run->tasks[task_id] = task;
+        Run->runtimes[task_id] = task_runtime;
+    }
+}
+
+// Posts the arrival of the next task, the queue holds one arrival at a time
+static void PostNextArrival() {
+    if(Run->posted_arrivals < Run->tasks.size()) {
+        Post(Run->tasks[Run->posted_arrivals].arrival, TASK_ARRIVAL, Run->posted_arrivals);
+        Run->posted_arrivals++;
+    }
+}
+
+typedef struct {
+    const SchedulerPolicy_t * policy;
+    unsigned num_machines;
+    unsigned num_tasks;
+    double utilization;
+    Time_t fork_time;
+    unsigned forks;                     // Continuations forked at fork_time, 0 for none
+    Time_t arrival_window;              // Bursts are delivered through HandleNewTasks() when not 0
+} BenchConfig_t;
+
+// Collects the arrivals that follow first within window and hands them to the scheduler in one call,
+// returns the number of arrival events merged into the burst
+static unsigned DeliverBurst(const BenchEvent_t & first, Time_t window) {
+    Uncounted uncounted;
+    vector<TaskId_t> & burst = Run->burst;
+    burst.assign(1, first.id);
+    while(!Run->events.empty() && Run->events.top().type == TASK_ARRIVAL && Run->events.top().time <= first.time + window) {
+        BenchEvent_t event = Run->events.top();
+        Run->events.pop();
+        Run->current_time = event.time;
+        burst.push_back(event.id);
+        PostNextArrival();
+    }
+    Measure(NEW_TASK, [&] { HandleNewTasks(Run->current_time, burst.data(), burst.size()); });
+    return burst.size() - 1;
+}
+
+static mutex OutputLock;            // SimulationComplete() and the report print to stdout
+
+// Forks the what-if continuations, returns the continuation the calling process carries on with (0 for the parent)
+static unsigned ForkContinuations(const BenchConfig_t & config, unsigned seed) {
+    cout.flush();
+    for(unsigned i = 1; i <= config.forks; i++) {
+        pid_t pid = fork();
+        if(pid < 0) {
+            ThrowException("ForkContinuations(): fork failed for continuation ", i);
+        }
+        if(pid == 0) {
+            LayOutTasks(Run->posted_arrivals, seed + i);
+            return i;
+        }
+    }
+    return 0;
+}
+
+static void RunBench(const BenchConfig_t & config, unsigned seed) {
+    BenchRun_t run = {};
+    SchedulerContext context;
+    context.policy = config.policy;
+    Run = &run;
+    SchedulerContext_Bind(&context);
+    unsigned num_machines = config.num_machines;
+    unsigned num_tasks = config.num_tasks;
+    double utilization = config.utilization;
+
+    // The cluster is laid out in blocks of machine classes, like the scenario files
+    uint64_t total_memory = 0;
+    for(unsigned i = 0; i < num_machines; i++) {
+        unsigned machine_class = i * MACHINE_CLASSES / num_machines;
+        Run->machines.push_back({machine_class, 0, 0, 0, S0, S0, 0});
+        total_memory += MachineClasses[machine_class].memory_size;
+    }
+
+    // Task sizes and runtimes, the arrival rate is chosen so that the expected memory in use meets the utilization
+    double mean_memory = (8 + 64 + 256 + 1024) / 4.0 + VM_MEMORY_OVERHEAD;
+    Run->mean_interarrival = MEAN_RUNTIME * mean_memory / (utilization * total_memory);
+    Run->tasks.resize(num_tasks);
+    Run->runtimes.resize(num_tasks);
+    Run->task_vms.assign(num_tasks, VMId_t(-1));
+    LayOutTasks(0, seed);
+    for(auto & stats : Run->stats) {
+        stats.latency.reserve(num_tasks);
+    }
+
+    InitScheduler();
+    PostNextArrival();
+    Post(TIMER_PERIOD, TIMER, 0);
+
+    uint64_t events = 0;
+    unsigned continuation = 0;
+    bool forked = config.forks == 0;
+    Run->pending_tasks = num_tasks;
+    auto start = chrono::steady_clock::now();
+    while(!Run->events.empty() && Run->pending_tasks) {
+        if(!forked && Run->events.top().time >= config.fork_time) {
+            continuation = ForkContinuations(config, seed);
+            forked = true;
+        }
+        BenchEvent_t event = Run->events.top();
+        Run->events.pop();
+        Run->current_time = event.time;
+        events++;
+        switch(event.type) {
+            case TASK_ARRIVAL:
+                PostNextArrival();
+                if(config.arrival_window) {
+                    events += DeliverBurst(event, config.arrival_window);
+                    break;
+                }
+                Measure(NEW_TASK, [&] { HandleNewTask(Run->current_time, event.id); });
+                break;
+            case TASK_COMPLETION: {
+                VMId_t vm_id = Run->task_vms[event.id];
+                if(vm_id == VMId_t(-1)) {
+                    break;
+                }
+                VM_RemoveTask(vm_id, event.id);
+                Run->tasks[event.id].completed = true;
+                Run->tasks[event.id].completion = Run->current_time;
+                Run->pending_tasks--;
+                Measure(TASK_COMPLETE, [&] { HandleTaskCompletion(Run->current_time, event.id); });
+                break;
+            }
+            case MIGRATION_DONE: {
+                BenchVM_t & vm = Run->vms[event.id];
+                if(vm.destination == vm.machine_id) {
+                    break;
+                }
+                unsigned memory = VM_MEMORY_OVERHEAD;
+                for(TaskId_t task_id : vm.tasks) {
+                    memory += Run->tasks[task_id].required_memory;
+                }
+                Charge(vm.machine_id, -int(memory), -int(vm.tasks.size()));
+                Run->machines[vm.machine_id].active_vms--;
+                vm.machine_id = vm.destination;
+                Measure(MIGRATION_COMPLETE, [&] { MigrationDone(Run->current_time, event.id); });
+                break;
+            }
+            case STATE_CHANGE:
+                Run->machines[event.id].s_state = Run->machines[event.id].next_state;
+                Measure(STATE_CHANGE_COMPLETE, [&] { StateChangeComplete(Run->current_time, event.id); });
+                break;
+            case TIMER:
+                AccountEnergy(TIMER_PERIOD);
+                Post(Run->current_time + TIMER_PERIOD, TIMER, 0);
+                Measure(SCHEDULER_CHECK, [&] { SchedulerCheck(Run->current_time); });
+                // Only the next tick is left and every pending task is still waiting for admission
+                if(Run->events.size() == 1 && Run->events.top().type == TIMER &&
+                   Run->pending_tasks == CurrentContext->admission.Size()) {
+                    Run->events.pop();
+                }
+                break;
+        }
+    }
+    // Tasks that are still waiting for admission when the events run out are never placed
+    for(TaskId_t task_id = 0; task_id < Run->tasks.size(); task_id++) {
+        if(Run->task_vms[task_id] == VMId_t(-1) && !Run->tasks[task_id].completed) {
+            DropTask(task_id);
+        }
+    }
+    double wall_seconds = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+
+    lock_guard<mutex> lock(OutputLock);
+    // Continuations run in separate processes, each report is written in one piece so they do not interleave
+    stringstream report;
+    streambuf * stdout_buffer = cout.rdbuf(report.rdbuf());
+    cout << config.policy->name << " seed " << seed;
+    if(config.forks) {
+        cout << " continuation " << continuation;
+    }
+    cout << endl;
+    SimulationComplete(Run->current_time);
+    Report(wall_seconds, events);
+    cout.rdbuf(stdout_buffer);
+    cout << report.str() << flush;
+    SchedulerContext_Bind(nullptr);
+    Run = nullptr;
+    if(continuation != 0) {
+        _exit(0);
+    }
+    while(config.forks && wait(nullptr) > 0) {
+    }
+}
+
+int main(int argc, char * argv[]) {
+    BenchConfig_t config = {Scheduler_DefaultPolicy(), 1000, 200000, 0.6, 0, 0, 0};
+    unsigned seed = 520230;
+    unsigned runs = 1;
+    for(int i = 1; i + 1 < argc; i += 2) {
+        if(!strcmp(argv[i], "-p")) config.policy = Scheduler_FindPolicy(argv[i + 1]);
+        else if(!strcmp(argv[i], "-m")) config.num_machines = atoi(argv[i + 1]);
+        else if(!strcmp(argv[i], "-t")) config.num_tasks = atoi(argv[i + 1]);
+        else if(!strcmp(argv[i], "-u")) config.utilization = atof(argv[i + 1]);
+        else if(!strcmp(argv[i], "-s")) seed = atoi(argv[i + 1]);
+        else if(!strcmp(argv[i], "-j")) runs = atoi(argv[i + 1]);
+        else if(!strcmp(argv[i], "-f")) config.fork_time = strtoull(argv[i + 1], nullptr, 10);
+        else if(!strcmp(argv[i], "-n")) config.forks = atoi(argv[i + 1]);
+        else if(!strcmp(argv[i], "-w")) config.arrival_window = strtoull(argv[i + 1], nullptr, 10);
+        else {
+            cerr << "usage: " << argv[0] << " [-p policy] [-m machines] [-t tasks] [-u utilization] [-s seed] [-j runs] [-f time -n count] [-w window]" << endl;
+            return 1;
+        }
+    }
+    // SimOutput() drops every message here, so the scheduler should not spend time formatting them
+    if(getenv("CLOUDSIM_VERBOSE") == nullptr) {
+        SchedulerLog_Level = 0;
+    }
+    if(config.policy == nullptr) {
+        cerr << argv[0] << ": unknown policy, expected greedy, pmapper, balanced or minutil" << endl;
+        return 1;
+    }
+    if(config.forks && runs > 1) {
+        cerr << argv[0] << ": -n forks the process and cannot be combined with -j" << endl;
+        return 1;
+    }
+
+    // Runs with consecutive seeds, each on its own thread with its own scheduler context
+    vector<thread> threads;
+    for(unsigned i = 0; i < runs; i++) {
+        threads.emplace_back(RunBench, config, seed + i);
+    }
+    for(auto & t : threads) {
+        t.join();
+    }
+    return 0;
+}
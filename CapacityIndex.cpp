@@ -0,0 +1,150 @@
+//
+//  CapacityIndex.cpp
+//  CloudSim
+//
+
+#include <algorithm>
+
+#include "CapacityIndex.hpp"
+
+#define CPU_TYPES   (unsigned(X86) + 1)     // X86 is the last CPUType_t
+
+// First leaf at or after from with a value of at least need, or -1
+static long FirstAtLeast(const vector<int64_t> & tree, unsigned node, unsigned lo, unsigned hi, unsigned from, int64_t need) {
+    if(hi <= from || tree[node] < need) {
+        return -1;
+    }
+    if(hi - lo == 1) {
+        return lo;
+    }
+    unsigned mid = (lo + hi) / 2;
+    long found = FirstAtLeast(tree, 2 * node, lo, mid, from, need);
+    return found != -1 ? found : FirstAtLeast(tree, 2 * node + 1, mid, hi, from, need);
+}
+
+// Last leaf before to with a value of at least need, or -1
+static long LastAtLeast(const vector<int64_t> & tree, unsigned node, unsigned lo, unsigned hi, unsigned to, int64_t need) {
+    if(lo >= to || tree[node] < need) {
+        return -1;
+    }
+    if(hi - lo == 1) {
+        return lo;
+    }
+    unsigned mid = (lo + hi) / 2;
+    long found = LastAtLeast(tree, 2 * node + 1, mid, hi, to, need);
+    return found != -1 ? found : LastAtLeast(tree, 2 * node, lo, mid, to, need);
+}
+
+void CapacityIndex::Init(const vector<MachineId_t> & order) {
+    unsigned total_machines = order.size();
+    this->order = order;
+    position.assign(total_machines, 0);
+    partition_of.assign(total_machines, 0);
+    slot.assign(total_machines, 0);
+    free_memory.assign(total_machines, 0);
+    awake.assign(total_machines, false);
+    partitions.assign(CPU_TYPES * 2, Partition_t());
+
+    for(unsigned i = 0; i < total_machines; i++) {
+        MachineId_t machine_id = order[i];
+        const MachineView_t & machine_info = Machine_GetView(machine_id);
+        Partition_t & partition = partitions[PartitionOf(machine_info.cpu, machine_info.gpus)];
+        position[machine_id] = i;
+        partition_of[machine_id] = PartitionOf(machine_info.cpu, machine_info.gpus);
+        slot[machine_id] = partition.positions.size();
+        partition.positions.push_back(i);
+    }
+    for(auto & partition : partitions) {
+        partition.size = 1;
+        while(partition.size < partition.positions.size()) {
+            partition.size *= 2;
+        }
+        partition.max_free[0].assign(2 * partition.size, -1);
+        partition.max_free[1].assign(2 * partition.size, -1);
+        partition.asleep.assign(2 * partition.size, -1);
+    }
+    for(unsigned i = 0; i < total_machines; i++) {
+        MachineId_t machine_id = order[i];
+        const MachineView_t & machine_info = Machine_GetView(machine_id);
+        Partition_t & partition = partitions[partition_of[machine_id]];
+        free_memory[machine_id] = machine_info.memory_used < machine_info.memory_size ? machine_info.memory_size - machine_info.memory_used : 0;
+        awake[machine_id] = machine_info.s_state == S0;
+        SetLeaf(partition, partition.max_free[0], slot[machine_id], free_memory[machine_id]);
+        SetLeaf(partition, partition.max_free[1], slot[machine_id], awake[machine_id] ? int64_t(free_memory[machine_id]) : -1);
+        SetLeaf(partition, partition.asleep, slot[machine_id], awake[machine_id] ? 0 : 1);
+    }
+}
+
+void CapacityIndex::Update(MachineId_t machine_id) {
+    const MachineView_t & machine_info = Machine_GetView(machine_id);
+    unsigned free = machine_info.memory_used < machine_info.memory_size ? machine_info.memory_size - machine_info.memory_used : 0;
+    bool is_awake = machine_info.s_state == S0;
+    if(free == free_memory[machine_id] && is_awake == awake[machine_id]) {
+        return;
+    }
+
+    Partition_t & partition = partitions[partition_of[machine_id]];
+    free_memory[machine_id] = free;
+    awake[machine_id] = is_awake;
+
+    SetLeaf(partition, partition.max_free[0], slot[machine_id], free);
+    SetLeaf(partition, partition.max_free[1], slot[machine_id], is_awake ? int64_t(free) : -1);
+    SetLeaf(partition, partition.asleep, slot[machine_id], is_awake ? 0 : 1);
+}
+
+void CapacityIndex::SetLeaf(Partition_t & partition, vector<int64_t> & tree, unsigned slot, int64_t value) {
+    unsigned node = partition.size + slot;
+    tree[node] = value;
+    for(node /= 2; node >= 1; node /= 2) {
+        tree[node] = max(tree[2 * node], tree[2 * node + 1]);
+    }
+}
+
+MachineId_t CapacityIndex::FirstFit(const CapacityRequest_t & request, MachineId_t after) const {
+    unsigned best = order.size();
+    for(bool gpu : {false, true}) {
+        if(request.gpu && !gpu) {
+            continue;
+        }
+        const Partition_t & partition = partitions[PartitionOf(request.cpu, gpu)];
+        const vector<unsigned> & positions = partition.positions;
+        unsigned from = after == NO_MACHINE ? 0 : upper_bound(positions.begin(), positions.end(), position[after]) - positions.begin();
+        long found = FirstAtLeast(partition.max_free[request.awake], 1, 0, partition.size, from, request.memory);
+        if(found != -1 && positions[found] < best) {
+            best = positions[found];
+        }
+    }
+    return best < order.size() ? order[best] : NO_MACHINE;
+}
+
+MachineId_t CapacityIndex::LastFit(const CapacityRequest_t & request, MachineId_t before) const {
+    long best = -1;
+    for(bool gpu : {false, true}) {
+        if(request.gpu && !gpu) {
+            continue;
+        }
+        const Partition_t & partition = partitions[PartitionOf(request.cpu, gpu)];
+        const vector<unsigned> & positions = partition.positions;
+        unsigned to = before == NO_MACHINE ? positions.size() : lower_bound(positions.begin(), positions.end(), position[before]) - positions.begin();
+        long found = LastAtLeast(partition.max_free[request.awake], 1, 0, partition.size, to, request.memory);
+        if(found != -1 && long(positions[found]) > best) {
+            best = positions[found];
+        }
+    }
+    return best != -1 ? order[best] : NO_MACHINE;
+}
+
+MachineId_t CapacityIndex::FirstAsleep(CPUType_t cpu, MachineId_t after, MachineId_t before) const {
+    unsigned limit = before == NO_MACHINE ? order.size() : position[before];
+    unsigned best = limit;
+    for(bool gpu : {false, true}) {
+        const Partition_t & partition = partitions[PartitionOf(cpu, gpu)];
+        const vector<unsigned> & positions = partition.positions;
+        unsigned from = after == NO_MACHINE ? 0 : upper_bound(positions.begin(), positions.end(), position[after]) - positions.begin();
+        long found = FirstAtLeast(partition.asleep, 1, 0, partition.size, from, 1);
+        if(found != -1 && positions[found] < best) {
+            best = positions[found];
+        }
+    }
+    return best < limit ? order[best] : NO_MACHINE;
+}
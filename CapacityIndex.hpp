@@ -0,0 +1,55 @@
+//
+//  CapacityIndex.hpp
+//  CloudSim
+//
+//  Free-memory index over the machines, partitioned by CPU type, GPU flag and power state, so that a policy
+//  can find a host in O(log M) instead of scanning the whole cluster. The machines keep the order in which the
+//  policy scans them, FirstFit() and LastFit() return what a forward or backward scan would have stopped at.
+//
+
+#ifndef CapacityIndex_hpp
+#define CapacityIndex_hpp
+
+#include <vector>
+
+#include "Interfaces.h"
+#include "MachineView.h"
+#include "PlacementIndex.hpp"
+
+typedef struct {
+    CPUType_t cpu;                          // CPU type the machine must have
+    unsigned memory;                        // Free memory the machine must have
+    bool gpu;                               // Only machines equipped with a GPU
+    bool awake;                             // Only machines in S0
+} CapacityRequest_t;
+
+class CapacityIndex {
+public:
+    CapacityIndex()             {}
+    void Init(const vector<MachineId_t> & order);                   // Machines in the order the policy scans them
+    void Update(MachineId_t machine_id);                            // Re-reads one machine from the MachineView after it changed
+
+    MachineId_t FirstFit(const CapacityRequest_t & request, MachineId_t after = NO_MACHINE) const;
+    MachineId_t LastFit(const CapacityRequest_t & request, MachineId_t before = NO_MACHINE) const;
+    MachineId_t FirstAsleep(CPUType_t cpu, MachineId_t after, MachineId_t before) const;   // Not in S0, strictly between the two
+private:
+    typedef struct {
+        vector<unsigned> positions;                 // Scan positions of the members, ascending
+        unsigned size;                              // Number of leaves of the segment trees
+        vector<int64_t> max_free[2];                // Segment trees of free memory, [1] only counts machines in S0
+        vector<int64_t> asleep;                     // Segment tree of 1 for machines not in S0, 0 otherwise
+    } Partition_t;
+
+    static unsigned PartitionOf(CPUType_t cpu, bool gpu)    { return unsigned(cpu) * 2 + (gpu ? 1 : 0); }
+    void SetLeaf(Partition_t & partition, vector<int64_t> & tree, unsigned slot, int64_t value);
+
+    vector<MachineId_t> order;              // scan position -> machine
+    vector<unsigned> position;              // machine -> scan position
+    vector<unsigned> partition_of;          // machine -> partition
+    vector<unsigned> slot;                  // machine -> leaf in its partition
+    vector<unsigned> free_memory;           // machine -> free memory as last observed
+    vector<bool> awake;                     // machine -> in S0 as last observed
+    vector<Partition_t> partitions;         // Indexed by PartitionOf()
+};
+
+#endif /* CapacityIndex_hpp */
@@ -0,0 +1,77 @@
+//
+//  MachineView.cpp
+//  CloudSim
+//
+
+#include "Interfaces.h"
+#include "MachineView.h"
+#include "SchedulerContext.hpp"
+
+static const MachinePowerTables_t * SharePowerTables(const MachineInfo_t & info) {
+    deque<MachinePowerTables_t> & power_tables = CurrentContext->machine_views.power_tables;
+    for(auto & tables : power_tables) {
+        if(tables.performance == info.performance && tables.c_states == info.c_states &&
+           tables.p_states == info.p_states && tables.s_states == info.s_states) {
+            return &tables;
+        }
+    }
+    power_tables.push_back({info.performance, info.c_states, info.p_states, info.s_states});
+    return &power_tables.back();
+}
+
+static void Refresh(MachineView_t & view) {
+    PROFILE_SCOPE(PROFILE_MACHINE_GET_INFO);
+    MachineInfo_t info = Machine_GetInfo(view.machine_id);
+    view.memory_used = info.memory_used;
+    view.active_tasks = info.active_tasks;
+    view.active_vms = info.active_vms;
+    view.s_state = info.s_state;
+    view.p_state = info.p_state;
+    view.stale = false;
+}
+
+void MachineView_Init() {
+    unsigned total_machines = Machine_GetTotal();
+    vector<MachineView_t> & views = CurrentContext->machine_views.views;
+    views.clear();
+    views.reserve(total_machines);
+    CurrentContext->machine_views.power_tables.clear();
+    for(unsigned i = 0; i < total_machines; i++) {
+        PROFILE_SCOPE(PROFILE_MACHINE_GET_INFO);
+        MachineInfo_t info = Machine_GetInfo(MachineId_t(i));
+        MachineView_t view;
+        view.num_cpus = info.num_cpus;
+        view.cpu = info.cpu;
+        view.memory_size = info.memory_size;
+        view.memory_used = info.memory_used;
+        view.active_tasks = info.active_tasks;
+        view.active_vms = info.active_vms;
+        view.gpus = info.gpus;
+        view.s_state = info.s_state;
+        view.p_state = info.p_state;
+        view.machine_id = info.machine_id;
+        view.power = SharePowerTables(info);
+        view.stale = false;
+        views.push_back(view);
+    }
+}
+
+void MachineView_Invalidate(MachineId_t machine_id) {
+    CurrentContext->machine_views.views[machine_id].stale = true;
+}
+
+const MachineView_t & Machine_GetView(MachineId_t machine_id) {
+    MachineView_t & view = CurrentContext->machine_views.views[machine_id];
+    if(view.stale) {
+        Refresh(view);
+    }
+    return view;
+}
+
+CPUType_t Machine_GetCPU(MachineId_t machine_id) {
+    return CurrentContext->machine_views.views[machine_id].cpu;
+}
+
+unsigned Machine_GetMemorySize(MachineId_t machine_id) {
+    return CurrentContext->machine_views.views[machine_id].memory_size;
+}
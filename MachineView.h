@@ -0,0 +1,57 @@
+//
+//  MachineView.h
+//  CloudSim
+//
+//  Allocation-free query surface over the Machine module. Machine_GetInfo() copies the four power tables
+//  of MachineInfo_t on every call; the view reads them once, shares them between machines with identical
+//  tables and keeps a scalar copy of the dynamic machine state.
+//
+//  The dynamic fields are re-read lazily, on the first Machine_GetView() after MachineView_Invalidate().
+//  The scheduler invalidates a machine whenever it changes it (VM attach, task add, VM shutdown, migration)
+//  or is told that it changed (task completion, migration completion, state change completion), so a
+//  placement loop never calls Machine_GetInfo() more often than before and usually not at all.
+//
+
+#ifndef MachineView_h
+#define MachineView_h
+
+#include <deque>
+#include <vector>
+
+#include "SimTypes.h"
+
+typedef struct {
+    vector<unsigned> performance;           // The MIPS ratings for the CPUs at different p-state
+    vector<unsigned> c_states;              // Power consumption under different C states
+    vector<unsigned> p_states;              // Power consumption for cores at different P states
+    vector<unsigned> s_states;              // Machine power consumption under different S states
+} MachinePowerTables_t;
+
+typedef struct {
+    unsigned num_cpus;                      // Number of CPU's on the machine
+    CPUType_t cpu;                          // CPU types deployed in the machine
+    unsigned memory_size;                   // Size of memory
+    unsigned memory_used;                   // The memory currently in use
+    unsigned active_tasks;                  // Number of tasks that are assigned to this machine
+    unsigned active_vms;                    // Number of virtual machines that are attached to this machine
+    bool gpus;                              // True if the processors are equipped with a GPU, false otherwise
+    MachineState_t s_state;                 // The current S state of the machine
+    CPUPerformance_t p_state;               // The current P state of the CPUs
+    MachineId_t machine_id;                 // The identifier of the machine
+    const MachinePowerTables_t * power;     // Shared by all machines with the same tables
+    bool stale;                             // The dynamic fields need to be re-read
+} MachineView_t;
+
+typedef struct {
+    vector<MachineView_t> views;
+    deque<MachinePowerTables_t> power_tables;   // deque keeps the addresses stable as classes are added
+} MachineViewTable_t;                           // Owned by the SchedulerContext
+
+extern void                     MachineView_Init();                                 // Reads every machine once, call from InitScheduler()
+extern void                     MachineView_Invalidate(MachineId_t machine_id);     // The dynamic state of the machine changed
+
+extern const MachineView_t &    Machine_GetView(MachineId_t machine_id);
+extern CPUType_t                Machine_GetCPU(MachineId_t machine_id);
+extern unsigned                 Machine_GetMemorySize(MachineId_t machine_id);
+
+#endif /* MachineView_h */
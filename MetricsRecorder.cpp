@@ -0,0 +1,125 @@
+//
+//  MetricsRecorder.cpp
+//  CloudSim
+//
+
+#include <cstring>
+
+#include "MachineView.h"
+#include "MetricsRecorder.hpp"
+
+#define METRICS_BUFFER  (4 << 20)       // Bytes filled before the buffer is handed to the writer
+
+MetricsRecorder::MetricsRecorder(const string & path, Time_t interval) : interval(interval) {
+    file = fopen(path.c_str(), "wb");
+    if(file == nullptr) {
+        ThrowException("MetricsRecorder: Cannot open metrics file ", path);
+    }
+    csv = path.size() >= 4 && path.compare(path.size() - 4, 4, ".csv") == 0;
+    filling.reserve(METRICS_BUFFER);
+    pending.reserve(METRICS_BUFFER);
+    if(csv) {
+        const char header[] = "time,machine,energy,s_state,active_tasks,active_vms,memory_used\n";
+        Append(header, strlen(header));
+    }
+    else {
+        uint64_t magic = METRICS_MAGIC;
+        Append(&magic, sizeof(magic));
+    }
+    writer = thread(&MetricsRecorder::Write, this);
+}
+
+MetricsRecorder::~MetricsRecorder() {
+    Hand();
+    {
+        lock_guard<mutex> guard(lock);
+        closing = true;
+    }
+    changed.notify_all();
+    writer.join();
+    fclose(file);
+}
+
+void MetricsRecorder::Sample(Time_t time, bool force) {
+    // A forced sample is only skipped when the machines were already recorded at this time
+    if(force ? time == last_sample : time < next_sample) {
+        return;
+    }
+    next_sample = time + interval;
+    last_sample = time;
+    if(csv) {
+        AppendRows(time);
+    }
+    else {
+        AppendSample(time);
+    }
+    if(filling.size() >= METRICS_BUFFER) {
+        Hand();
+    }
+}
+
+void MetricsRecorder::Append(const void * data, size_t size) {
+    const char * bytes = (const char *) data;
+    filling.insert(filling.end(), bytes, bytes + size);
+}
+
+void MetricsRecorder::AppendSample(Time_t time) {
+    unsigned total_machines = Machine_GetTotal();
+    MetricsSample_t sample = {time, total_machines, 0};
+    Append(&sample, sizeof(sample));
+
+    // The columns are filled in place, they are not aligned past s_state so every value is copied in
+    size_t offset = filling.size();
+    filling.resize(offset + total_machines * (sizeof(uint64_t) + sizeof(uint8_t) + 3 * sizeof(uint32_t)));
+    char * energy = &filling[offset];
+    char * s_state = energy + total_machines * sizeof(uint64_t);
+    char * active_tasks = s_state + total_machines * sizeof(uint8_t);
+    char * active_vms = active_tasks + total_machines * sizeof(uint32_t);
+    char * memory_used = active_vms + total_machines * sizeof(uint32_t);
+    for(unsigned i = 0; i < total_machines; i++) {
+        const MachineView_t & view = Machine_GetView(MachineId_t(i));
+        uint64_t machine_energy = Machine_GetEnergy(MachineId_t(i));
+        uint32_t values[3] = {view.active_tasks, view.active_vms, view.memory_used};
+        memcpy(energy + i * sizeof(uint64_t), &machine_energy, sizeof(uint64_t));
+        s_state[i] = char(view.s_state);
+        memcpy(active_tasks + i * sizeof(uint32_t), &values[0], sizeof(uint32_t));
+        memcpy(active_vms + i * sizeof(uint32_t), &values[1], sizeof(uint32_t));
+        memcpy(memory_used + i * sizeof(uint32_t), &values[2], sizeof(uint32_t));
+    }
+}
+
+void MetricsRecorder::AppendRows(Time_t time) {
+    char row[128];
+    unsigned total_machines = Machine_GetTotal();
+    for(unsigned i = 0; i < total_machines; i++) {
+        const MachineView_t & view = Machine_GetView(MachineId_t(i));
+        int length = snprintf(row, sizeof(row), "%llu,%u,%llu,%u,%u,%u,%u\n", (unsigned long long) time, i,
+                              (unsigned long long) Machine_GetEnergy(MachineId_t(i)), unsigned(view.s_state),
+                              view.active_tasks, view.active_vms, view.memory_used);
+        Append(row, length);
+    }
+}
+
+void MetricsRecorder::Hand() {
+    unique_lock<mutex> guard(lock);
+    changed.wait(guard, [this] { return pending.empty(); });
+    pending.swap(filling);
+    guard.unlock();
+    changed.notify_all();
+}
+
+void MetricsRecorder::Write() {
+    unique_lock<mutex> guard(lock);
+    for(;;) {
+        changed.wait(guard, [this] { return !pending.empty() || closing; });
+        if(pending.empty()) {
+            return;
+        }
+        // The simulation thread only touches pending through Hand(), which waits for it to be empty
+        guard.unlock();
+        fwrite(pending.data(), 1, pending.size(), file);
+        guard.lock();
+        pending.clear();
+        changed.notify_all();
+    }
+}
@@ -0,0 +1,63 @@
+//
+//  MetricsRecorder.hpp
+//  CloudSim
+//
+//  Periodic per-machine samples of energy, S-state, active tasks, active VMs and memory in use, taken from
+//  SchedulerCheck() at most once per interval, plus a final sample from SimulationComplete() regardless of the
+//  interval. The machine state is the MachineView's, as the scheduler sees it.
+//
+//  Samples are appended to an in-memory buffer, and full buffers are written by a background thread so the
+//  simulation does not wait on the file. The binary format is columnar, each sample is a MetricsSample_t
+//  followed by one array per column, in the order of MetricsSample_t's comments. The CSV format has one row
+//  per machine and sample.
+//
+//  Enabled with CLOUDSIM_METRICS=file, CSV when the name ends in .csv, CLOUDSIM_METRICS_INTERVAL sets the
+//  interval in microseconds (1 second by default).
+//
+
+#ifndef MetricsRecorder_hpp
+#define MetricsRecorder_hpp
+
+#include <condition_variable>
+#include <cstdio>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "Interfaces.h"
+
+#define METRICS_MAGIC   0x3143495254454d53ULL     // "SMETRIC1", at the start of a binary file
+
+typedef struct {
+    uint64_t time;
+    uint32_t machines;      // Followed by uint64_t energy, uint8_t s_state, uint32_t active_tasks,
+    uint32_t reserved;      // uint32_t active_vms and uint32_t memory_used, each machines long
+} MetricsSample_t;
+
+class MetricsRecorder {
+public:
+    MetricsRecorder(const string & path, Time_t interval);
+    ~MetricsRecorder();                                 // Writes the remaining samples and closes the file
+    void Sample(Time_t time, bool force = false);       // Records all machines if the interval has elapsed or force is set
+private:
+    void Append(const void * data, size_t size);
+    void AppendSample(Time_t time);
+    void AppendRows(Time_t time);
+    void Hand();                                        // Passes the filled buffer to the writer
+    void Write();                                       // Writer thread
+
+    FILE * file;
+    bool csv;
+    Time_t interval;
+    Time_t next_sample = 0;
+    Time_t last_sample = (Time_t) -1;                   // Time of the latest sample, -1 before the first
+    vector<char> filling;                               // Appended to by the simulation thread
+    vector<char> pending;                               // Being written by the writer thread
+    bool closing = false;
+    mutex lock;
+    condition_variable changed;
+    thread writer;
+};
+
+#endif /* MetricsRecorder_hpp */
@@ -0,0 +1,108 @@
+//
+//  PlacementIndex.cpp
+//  CloudSim
+//
+
+#include <algorithm>
+
+#include "PlacementIndex.hpp"
+
+void PlacementIndex::Init(unsigned total_machines) {
+    machine_vms.assign(total_machines, vector<VMId_t>());
+    machine_tasks.assign(total_machines, 0);
+    vm_machine.clear();
+    vm_destination.clear();
+    vm_tasks.clear();
+    spare_tasks.clear();
+    task_vm.clear();
+}
+
+void PlacementIndex::AttachVM(VMId_t vm_id, MachineId_t machine_id) {
+    if(vm_id >= vm_machine.size()) {
+        vm_machine.resize(vm_id + 1, NO_MACHINE);
+        vm_destination.resize(vm_id + 1, NO_MACHINE);
+        vm_tasks.resize(vm_id + 1);
+    }
+    if(vm_tasks[vm_id].capacity() == 0 && !spare_tasks.empty()) {
+        vm_tasks[vm_id].swap(spare_tasks.back());
+        spare_tasks.pop_back();
+    }
+    vm_machine[vm_id] = machine_id;
+    machine_vms[machine_id].push_back(vm_id);
+}
+
+void PlacementIndex::AddTask(VMId_t vm_id, TaskId_t task_id) {
+    if(task_id >= task_vm.size()) {
+        task_vm.resize(task_id + 1, NO_VM);
+    }
+    task_vm[task_id] = vm_id;
+    vm_tasks[vm_id].push_back(task_id);
+    machine_tasks[vm_machine[vm_id]]++;
+}
+
+VMId_t PlacementIndex::RemoveTask(TaskId_t task_id) {
+    VMId_t vm_id = TaskVM(task_id);
+    if(vm_id == NO_VM) {
+        return NO_VM;
+    }
+    task_vm[task_id] = NO_VM;
+    vector<TaskId_t> & tasks = vm_tasks[vm_id];
+    tasks.erase(find(tasks.begin(), tasks.end(), task_id));
+    machine_tasks[vm_machine[vm_id]]--;
+    return vm_id;
+}
+
+void PlacementIndex::StartMigration(VMId_t vm_id, MachineId_t destination) {
+    vm_destination[vm_id] = destination;
+}
+
+MachineId_t PlacementIndex::CompleteMigration(VMId_t vm_id) {
+    MachineId_t source = vm_machine[vm_id];
+    if(vm_destination[vm_id] != NO_MACHINE) {
+        MoveVM(vm_id, vm_destination[vm_id]);
+        vm_destination[vm_id] = NO_MACHINE;
+    }
+    return source;
+}
+
+void PlacementIndex::MoveVM(VMId_t vm_id, MachineId_t machine_id) {
+    MachineId_t current = vm_machine[vm_id];
+    if(current == machine_id) {
+        return;
+    }
+    vector<VMId_t> & current_vms = machine_vms[current];
+    current_vms.erase(find(current_vms.begin(), current_vms.end(), vm_id));
+    machine_tasks[current] -= vm_tasks[vm_id].size();
+
+    vm_machine[vm_id] = machine_id;
+    machine_vms[machine_id].push_back(vm_id);
+    machine_tasks[machine_id] += vm_tasks[vm_id].size();
+}
+
+void PlacementIndex::DetachVM(VMId_t vm_id) {
+    MachineId_t machine_id = VMMachine(vm_id);
+    if(machine_id == NO_MACHINE) {
+        return;
+    }
+    vector<VMId_t> & vms = machine_vms[machine_id];
+    vms.erase(find(vms.begin(), vms.end(), vm_id));
+    machine_tasks[machine_id] -= vm_tasks[vm_id].size();
+    vm_machine[vm_id] = NO_MACHINE;
+    vm_destination[vm_id] = NO_MACHINE;
+    vm_tasks[vm_id].clear();
+    if(vm_tasks[vm_id].capacity() != 0) {
+        spare_tasks.push_back(move(vm_tasks[vm_id]));
+    }
+}
+
+void PlacementIndex::Clear() {
+    for(auto & vms : machine_vms) {
+        vms.clear();
+    }
+    fill(machine_tasks.begin(), machine_tasks.end(), 0);
+    vm_machine.clear();
+    vm_destination.clear();
+    vm_tasks.clear();
+    spare_tasks.clear();
+    task_vm.clear();
+}
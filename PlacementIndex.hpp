@@ -0,0 +1,51 @@
+//
+//  PlacementIndex.hpp
+//  CloudSim
+//
+//  Keeps the scheduler's view of which VMs live on which machine and which VM hosts each task,
+//  so that placement decisions do not need to walk every VM through VM_GetInfo().
+//  The index of the current SchedulerContext also backs VM_GetMachine(), VM_GetTaskCount() and VM_GetTasks().
+//
+
+#ifndef PlacementIndex_hpp
+#define PlacementIndex_hpp
+
+#include <vector>
+
+#include "Interfaces.h"
+
+#define NO_MACHINE  ((MachineId_t) -1)
+#define NO_VM       ((VMId_t) -1)
+
+class PlacementIndex {
+public:
+    PlacementIndex()            {}
+    void Init(unsigned total_machines);
+    void AttachVM(VMId_t vm_id, MachineId_t machine_id);
+    void AddTask(VMId_t vm_id, TaskId_t task_id);
+    VMId_t RemoveTask(TaskId_t task_id);                    // Returns the VM that hosted the task, or NO_VM
+    void StartMigration(VMId_t vm_id, MachineId_t destination);
+    MachineId_t CompleteMigration(VMId_t vm_id);            // Moves the VM to its destination, returns the source machine
+    void DetachVM(VMId_t vm_id);
+    void Clear();
+
+    const vector<VMId_t> & MachineVMs(MachineId_t machine_id) const    { return machine_vms[machine_id]; }
+    unsigned MachineTasks(MachineId_t machine_id) const                 { return machine_tasks[machine_id]; }
+    MachineId_t VMMachine(VMId_t vm_id) const                           { return vm_id < vm_machine.size() ? vm_machine[vm_id] : NO_MACHINE; }
+    unsigned VMTaskCount(VMId_t vm_id) const                            { return vm_id < vm_tasks.size() ? vm_tasks[vm_id].size() : 0; }
+    const vector<TaskId_t> & VMTasks(VMId_t vm_id) const                { return vm_id < vm_tasks.size() ? vm_tasks[vm_id] : no_tasks; }
+    VMId_t TaskVM(TaskId_t task_id) const                               { return task_id < task_vm.size() ? task_vm[task_id] : NO_VM; }
+private:
+    void MoveVM(VMId_t vm_id, MachineId_t machine_id);
+
+    vector<vector<VMId_t>> machine_vms;     // machine -> VMs attached to it
+    vector<unsigned> machine_tasks;         // machine -> number of tasks running in its VMs
+    vector<MachineId_t> vm_machine;         // VM -> machine it is attached to
+    vector<MachineId_t> vm_destination;     // VM -> machine it is migrating to, or NO_MACHINE
+    vector<vector<TaskId_t>> vm_tasks;      // VM -> tasks it hosts
+    vector<vector<TaskId_t>> spare_tasks;   // Task lists of detached VMs, handed to the next VMs attached
+    vector<VMId_t> task_vm;                 // task -> VM hosting it
+    vector<TaskId_t> no_tasks;              // Always empty, returned for unknown VMs
+};
+
+#endif /* PlacementIndex_hpp */
@@ -0,0 +1,73 @@
+//
+//  Profiler.cpp
+//  CloudSim
+//
+
+#include <cstdio>
+
+#include "Profiler.h"
+#include "SchedulerContext.hpp"
+
+static const char * SectionNames[PROFILE_SECTIONS] = {
+    "Simulator", "InitScheduler", "HandleNewTask", "HandleNewTasks", "HandleTaskCompletion", "MemoryWarning",
+    "MigrationDone", "SchedulerCheck", "SimulationComplete", "SLAWarning", "StateChangeComplete", "Machine_GetInfo",
+    "Machine_GetEnergy", "Machine_SetState", "Machine_SetCorePerformance", "GetTaskInfo", "VM_Create", "VM_Attach",
+    "VM_AddTask", "VM_Migrate", "VM_Shutdown"
+};
+
+void Profile_Add(ProfileSection_t section, uint64_t ns) {
+    ProfileStats_t & stats = CurrentContext->profile.sections[section];
+    unsigned bucket = 0;
+    while(bucket + 1 < PROFILE_BUCKETS && (ns >> (bucket + 1)) != 0) {
+        bucket++;
+    }
+    stats.calls++;
+    stats.total_ns += ns;
+    stats.max_ns = max(stats.max_ns, ns);
+    stats.buckets[bucket]++;
+}
+
+void Profile_EnterCallback() {
+    ProfileTable_t & profile = CurrentContext->profile;
+    if(profile.depth++ == 0 && profile.callback_end != chrono::steady_clock::time_point()) {
+        Profile_Add(PROFILE_SIMULATOR, chrono::duration_cast<chrono::nanoseconds>(chrono::steady_clock::now() - profile.callback_end).count());
+    }
+}
+
+void Profile_ExitCallback() {
+    ProfileTable_t & profile = CurrentContext->profile;
+    if(--profile.depth == 0) {
+        profile.callback_end = chrono::steady_clock::now();
+    }
+}
+
+// Upper bound of the bucket holding the given fraction of the calls
+static uint64_t Percentile(const ProfileStats_t & stats, double fraction) {
+    uint64_t rank = uint64_t(fraction * (stats.calls - 1)) + 1;
+    uint64_t seen = 0;
+    for(unsigned bucket = 0; bucket < PROFILE_BUCKETS; bucket++) {
+        seen += stats.buckets[bucket];
+        if(seen >= rank) {
+            return min(stats.max_ns, (uint64_t(2) << bucket) - 1);
+        }
+    }
+    return stats.max_ns;
+}
+
+void Profile_Report() {
+    const ProfileTable_t & profile = CurrentContext->profile;
+    char line[160];
+    snprintf(line, sizeof(line), "%-26s %10s %12s %10s %10s %10s %12s\n", "profile", "calls", "total ms", "mean ns", "p50 ns", "p99 ns", "max ns");
+    cout << line;
+    for(unsigned i = 0; i < PROFILE_SECTIONS; i++) {
+        const ProfileStats_t & stats = profile.sections[i];
+        if(stats.calls == 0) {
+            continue;
+        }
+        snprintf(line, sizeof(line), "%-26s %10llu %12.3f %10llu %10llu %10llu %12llu\n", SectionNames[i], (unsigned long long) stats.calls,
+               stats.total_ns / 1e6, (unsigned long long) (stats.total_ns / stats.calls),
+               (unsigned long long) Percentile(stats, 0.5), (unsigned long long) Percentile(stats, 0.99),
+               (unsigned long long) stats.max_ns);
+        cout << line;
+    }
+}
@@ -0,0 +1,101 @@
+//
+//  Profiler.h
+//  CloudSim
+//
+//  Opt-in wall-clock profile of the scheduler's hot paths, built with make PROFILE=1 (which defines
+//  CLOUDSIM_PROFILE). Without it PROFILE_SCOPE() expands to nothing and the build is unchanged.
+//
+//  Each scope adds its duration to a section: the scheduler entry points, the Machine, VM and Task calls the
+//  scheduler makes, and the simulator itself, measured as the time between the end of one callback and the start
+//  of the next since the event loop is prebuilt. Times are inclusive, a callback includes the module calls it
+//  makes. Latencies go into power-of-two buckets, so the reported percentiles are upper bounds within 2x.
+//  The breakdown is printed when the simulation completes.
+//
+
+#ifndef Profiler_h
+#define Profiler_h
+
+#include <chrono>
+#include <cstdint>
+
+#include "SimTypes.h"
+
+typedef enum {
+    PROFILE_SIMULATOR,                      // Between callbacks
+    PROFILE_INIT_SCHEDULER,
+    PROFILE_HANDLE_NEW_TASK,
+    PROFILE_HANDLE_NEW_TASKS,
+    PROFILE_HANDLE_TASK_COMPLETION,
+    PROFILE_MEMORY_WARNING,
+    PROFILE_MIGRATION_DONE,
+    PROFILE_SCHEDULER_CHECK,
+    PROFILE_SIMULATION_COMPLETE,
+    PROFILE_SLA_WARNING,
+    PROFILE_STATE_CHANGE_COMPLETE,
+    PROFILE_MACHINE_GET_INFO,
+    PROFILE_MACHINE_GET_ENERGY,
+    PROFILE_MACHINE_SET_STATE,
+    PROFILE_MACHINE_SET_CORE_PERFORMANCE,
+    PROFILE_GET_TASK_INFO,
+    PROFILE_VM_CREATE,
+    PROFILE_VM_ATTACH,
+    PROFILE_VM_ADD_TASK,
+    PROFILE_VM_MIGRATE,
+    PROFILE_VM_SHUTDOWN
+} ProfileSection_t;
+#define PROFILE_SECTIONS (PROFILE_VM_SHUTDOWN + 1)
+#define PROFILE_BUCKETS 64
+
+typedef struct {
+    uint64_t calls;
+    uint64_t total_ns;
+    uint64_t max_ns;
+    uint64_t buckets[PROFILE_BUCKETS];      // Bucket b counts latencies in [2^b, 2^(b+1)) ns
+} ProfileStats_t;
+
+typedef struct {
+    ProfileStats_t sections[PROFILE_SECTIONS];
+    unsigned depth;                         // Nesting of scheduler callbacks
+    chrono::steady_clock::time_point callback_end;
+} ProfileTable_t;                           // Owned by the SchedulerContext
+
+extern void Profile_Add(ProfileSection_t section, uint64_t ns);
+extern void Profile_EnterCallback();        // The gap since the last callback is the simulator's
+extern void Profile_ExitCallback();
+extern void Profile_Report();
+
+#ifdef CLOUDSIM_PROFILE
+
+class ProfileScope {
+public:
+    ProfileScope(ProfileSection_t section, bool callback = false) : section(section), callback(callback) {
+        if(callback) {
+            Profile_EnterCallback();
+        }
+        start = chrono::steady_clock::now();
+    }
+    ~ProfileScope() {
+        Profile_Add(section, chrono::duration_cast<chrono::nanoseconds>(chrono::steady_clock::now() - start).count());
+        if(callback) {
+            Profile_ExitCallback();
+        }
+    }
+private:
+    ProfileSection_t section;
+    bool callback;
+    chrono::steady_clock::time_point start;
+};
+
+#define PROFILE_SCOPE(section)      ProfileScope profile_scope(section)
+#define PROFILE_CALLBACK(section)   ProfileScope profile_scope(section, true)
+#define PROFILE_REPORT()            Profile_Report()
+
+#else
+
+#define PROFILE_SCOPE(section)
+#define PROFILE_CALLBACK(section)
+#define PROFILE_REPORT()
+
+#endif
+
+#endif /* Profiler_h */
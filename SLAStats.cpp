@@ -0,0 +1,78 @@
+//
+//  SLAStats.cpp
+//  CloudSim
+//
+
+#include <cmath>
+#include <cstring>
+
+#include "SLAStats.hpp"
+#include "TaskView.h"
+
+static const double Gamma = (1 + SLOWDOWN_ACCURACY) / (1 - SLOWDOWN_ACCURACY);
+static const double ViolationsAllowed[NUM_SLAS] = {5.0, 10.0, 20.0, 100.0};    // SLA3 is best effort
+
+// Bucket b holds slowdowns in (Gamma^(b - 1 - half), Gamma^(b - half)]
+static unsigned Bucket(double value) {
+    long bucket = value > 0 ? long(ceil(log(value) / log(Gamma))) + SLOWDOWN_BUCKETS / 2 : 0;
+    return unsigned(min(max(bucket, 0L), long(SLOWDOWN_BUCKETS - 1)));
+}
+
+static double BucketValue(unsigned bucket) {
+    // Midpoint of the bucket, within SLOWDOWN_ACCURACY of every value in it
+    return 2 * pow(Gamma, double(bucket) - SLOWDOWN_BUCKETS / 2) / (Gamma + 1);
+}
+
+void SLAStats::Init() {
+    memset(counters, 0, sizeof(counters));
+    memset(slowdown, 0, sizeof(slowdown));
+    warned.assign(GetNumTasks(), false);
+}
+
+void SLAStats::TaskCompleted(TaskId_t task_id, Time_t time) {
+    const TaskPlacementAttrs_t & task = Task_GetPlacementAttrs(task_id);
+    SLACounters_t & sla = counters[task.sla];
+    sla.completed++;
+    sla.violated += time > task.target_completion;
+    if(task_id < warned.size() && warned[task_id]) {
+        warned[task_id] = false;
+        sla.at_risk--;
+    }
+    Time_t allowed = task.target_completion > task.arrival ? task.target_completion - task.arrival : 1;
+    slowdown[task.sla][Bucket(double(time - task.arrival) / allowed)]++;
+}
+
+void SLAStats::TaskWarned(TaskId_t task_id) {
+    if(task_id >= warned.size()) {
+        warned.resize(task_id + 1, false);
+    }
+    if(!warned[task_id]) {
+        warned[task_id] = true;
+        counters[Task_GetPlacementAttrs(task_id).sla].at_risk++;
+    }
+}
+
+double SLAStats::ViolationRate(SLAType_t sla) const {
+    const SLACounters_t & counts = counters[sla];
+    return counts.completed ? 100.0 * counts.violated / counts.completed : 0.0;
+}
+
+double SLAStats::Margin(SLAType_t sla) const {
+    return ViolationsAllowed[sla] - ViolationRate(sla);
+}
+
+double SLAStats::SlowdownQuantile(SLAType_t sla, double q) const {
+    uint64_t completed = counters[sla].completed;
+    if(completed == 0) {
+        return 0.0;
+    }
+    uint64_t rank = uint64_t(q * (completed - 1)) + 1;
+    uint64_t seen = 0;
+    for(unsigned bucket = 0; bucket < SLOWDOWN_BUCKETS; bucket++) {
+        seen += slowdown[sla][bucket];
+        if(seen >= rank) {
+            return BucketValue(bucket);
+        }
+    }
+    return BucketValue(SLOWDOWN_BUCKETS - 1);
+}
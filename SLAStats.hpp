@@ -0,0 +1,47 @@
+//
+//  SLAStats.hpp
+//  CloudSim
+//
+//  Streaming SLA statistics that a policy can read at any point of the run, for example from PeriodicCheck(),
+//  to see how much margin each SLA class has left. Kept up to date by the scheduler hooks: HandleTaskCompletion()
+//  counts completed and violated tasks, SLAWarning() marks a task at risk until it completes.
+//
+//  Slowdown is (completion - arrival) / (target_completion - arrival), so 1.0 is a task that met its deadline
+//  exactly. Its distribution is kept in a log-bucketed sketch with a relative error of SLOWDOWN_ACCURACY.
+//  TaskInfo_t does not carry the task class, so the statistics are per SLA only.
+//
+
+#ifndef SLAStats_hpp
+#define SLAStats_hpp
+
+#include <vector>
+
+#include "Interfaces.h"
+
+#define SLOWDOWN_ACCURACY   0.02
+#define SLOWDOWN_BUCKETS    1024            // Covers slowdowns from about 1e-9 to 1e9
+
+typedef struct {
+    uint64_t completed;
+    uint64_t violated;                      // Completed after their target
+    uint64_t at_risk;                       // Warned through SLAWarning() and not completed yet
+} SLACounters_t;
+
+class SLAStats {
+public:
+    SLAStats()                  {}
+    void Init();
+    void TaskCompleted(TaskId_t task_id, Time_t time);
+    void TaskWarned(TaskId_t task_id);
+
+    const SLACounters_t & Counters(SLAType_t sla) const         { return counters[sla]; }
+    double ViolationRate(SLAType_t sla) const;                  // Percent of the completed tasks, 0 with none
+    double Margin(SLAType_t sla) const;                         // Violations still allowed by the SLA target, in percent
+    double SlowdownQuantile(SLAType_t sla, double q) const;     // 0 with no completed tasks
+private:
+    SLACounters_t counters[NUM_SLAS];
+    uint64_t slowdown[NUM_SLAS][SLOWDOWN_BUCKETS];
+    vector<bool> warned;                                        // task -> at risk
+};
+
+#endif /* SLAStats_hpp */
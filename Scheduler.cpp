@@ -4,144 +4,40 @@
 //
 //  Created by ELMOOTAZBELLAH ELNOZAHY on 10/20/24.
 //
+//  Policy registry and the public scheduler interface. The policies live in Algorithms/ and are all linked
+//  into the simulator, CLOUDSIM_POLICY selects one of greedy, pmapper, balanced or minutil (greedy by default).
+//
 
-#include "Scheduler.hpp"
-static Scheduler Scheduler;
-static bool migrating = false;
-static unsigned active_machines = 16;
-
-unsigned GetMachineUtilization(MachineId_t machine_id) {
-    unsigned utilization = 0; 
-    for (VMId_t vm_id : Scheduler.vms) {
-        VMInfo_t vm_info = VM_GetInfo(vm_id);
-        if (vm_info.machine_id == machine_id) {
-            utilization += vm_info.active_tasks.size();
-        }
-    }
-    return utilization;
-}
-void Scheduler::Init() {
-    // Find the parameters of the clusters
-    // Get the total number of machines
-    // For each machine:
-    //      Get the type of the machine
-    //      Get the memory of the machine
-    //      Get the number of CPUs
-    //      Get if there is a GPU or not
-    //
-    SimOutput("Scheduler::Init(): Total number of machines is " + to_string(Machine_GetTotal()), 3);
-    SimOutput("Scheduler::Init(): Initializing scheduler", 1);
-    unsigned total_machines = Machine_GetTotal();
-    for(unsigned i = 0; i < total_machines; i++) {
-        MachineId_t machine_id = MachineId_t(i);
-        machines.push_back(machine_id);
-
-        // MachineInfo_t info = Machine_GetInfo(machine_id);
-        // MachineState_t s_state = info.s_state;
-        // if (s_state != S5) {
-        //     unsigned num_cpus = info.num_cpus;
-        //     unsigned mem_size = info.memory_size;
-        //     bool gpu = info.gpus;
-        //     CPUType_t cpu = info.cpu;
-        // }
-
-    }
-}
-
-void Scheduler::MigrationComplete(Time_t time, VMId_t vm_id) {
-    // Update your data structure. The VM now can receive new tasks
-}
-
-void Scheduler::NewTask(Time_t now, TaskId_t task_id) {
-    // Greedy Algorithm
+#include <cstdlib>
 
-    bool task_gpu_capable = IsTaskGPUCapable(task_id);
-    unsigned task_memory = GetTaskMemory(task_id);
-    VMType_t task_vm_type = RequiredVMType(task_id);
-    SLAType_t task_sla = RequiredSLA(task_id);
-    CPUType_t task_cpu = RequiredCPUType(task_id);
+#include "SchedulerContext.hpp"
 
-    unsigned total_machines = Machine_GetTotal();
-    for (unsigned i = 0; i < total_machines; i++) {
-        //Getting machine info
-        MachineId_t machine_id = MachineId_t(i);
-        MachineInfo_t machine_info = Machine_GetInfo(machine_id);
+static const SchedulerPolicy_t * Policies[] = {
+    &GreedyPolicy,
+    &PMapperPolicy,
+    &BalancedPolicy,
+    &MinUtilPolicy
+};
 
-        //If the cpu is not compatible keep looking
-        if (task_cpu != machine_info.cpu) {
-            continue;
+const SchedulerPolicy_t * Scheduler_FindPolicy(const string & name) {
+    for(auto policy : Policies) {
+        if(name == policy->name) {
+            return policy;
         }
-        //make sure machine is awake
-        Machine_SetState(machine_id, S0);
-
-        //calculate the things
-        unsigned machine_utilization = GetMachineUtilization(machine_id);
-        float memory_utilization = (float) machine_info.memory_used / machine_info.memory_size;
-        float task_load_factor = (float) (task_memory + VM_MEMORY_OVERHEAD) / machine_info.memory_size;
-
-        if (machine_utilization + 1 < machine_info.num_cpus * 50 && memory_utilization + task_load_factor < 1.0) {
-            VMId_t vm_id = VM_Create(task_vm_type, task_cpu);
-            vms.push_back(vm_id);
-            VM_Attach(vm_id, machine_id);
-            VM_AddTask(vm_id, task_id, MID_PRIORITY);
-            return;
-        } 
     }
-    // SLA VIOLATION! :(
+    return nullptr;
 }
 
-void Scheduler::PeriodicCheck(Time_t now) {
-    // This method should be called from SchedulerCheck()
-    // SchedulerCheck is called periodically by the simulator to allow you to monitor, make decisions, adjustments, etc.
-    // Unlike the other invocations of the scheduler, this one doesn't report any specific event
-    // Recommendation: Take advantage of this function to do some monitoring and adjustments as necessary
+const SchedulerPolicy_t * Scheduler_DefaultPolicy() {
+    const char * name = getenv("CLOUDSIM_POLICY");
+    return name != nullptr ? Scheduler_FindPolicy(name) : &GreedyPolicy;
 }
 
-void Scheduler::Shutdown(Time_t time) {
-    // Do your final reporting and bookkeeping here.
-    // Report about the total energy consumed
-    // Report about the SLA compliance
-    // Shutdown everything to be tidy :-)
-    for(auto & vm: vms) {
-        VM_Shutdown(vm);
-    }
-    SimOutput("SimulationComplete(): Finished!", 4);
-    SimOutput("SimulationComplete(): Time is " + to_string(time), 4);
-}
-
-void Scheduler::TaskComplete(Time_t now, TaskId_t task_id) {
-    VMId_t vm_id = (VMId_t)-1;
-    MachineId_t machine_id = (MachineId_t)-1;
-    for (auto it = vms.begin(); it != vms.end(); ++it) {
-        VMInfo_t vm_info = VM_GetInfo(*it);
-        if(!vm_info.active_tasks.empty() && vm_info.active_tasks[0] == task_id){
-            //found our vm
-            vm_id = *it;
-            machine_id = vm_info.machine_id;
-            vms.erase(it);
-            break;
-        }
-    }
-
-    // Check if task is found
-    if (vm_id == (VMId_t)-1 || machine_id == (MachineId_t)-1) {
-        return;
-    }
-
-    SimOutput("Scheduler::TaskComplete(): Task " + to_string(task_id) + " is complete at " + to_string(now), 4);
-
-    VM_Shutdown(vm_id);
-   SimOutput("VM " + to_string(vm_id) + " shut down.", 4);
-
-
-    //Check if the machine is now idle
-    bool machine_idle = true;
-    for (const auto &vm : vms) {
-        VMInfo_t vm_info = VM_GetInfo(vm);
-        if (vm_info.machine_id == machine_id) {
-            machine_idle = false;
-            break;
-        }
+// Queues a task the policy left without a VM, it is offered again once capacity frees up
+static void Scheduler_AdmitOrQueue(TaskId_t task_id) {
+    if(CurrentScheduler().index.TaskVM(task_id) == NO_VM) {
+        SIM_LOG("Scheduler_AdmitOrQueue(): Task " + to_string(task_id) + " queued for admission", 3);
+        CurrentContext->admission.Push(task_id);
     }
 }
 
@@ -149,36 +45,100 @@ void Scheduler::TaskComplete(Time_t now, TaskId_t task_id) {
 
 
 void InitScheduler() {
-    SimOutput("InitScheduler(): Initializing scheduler", 4);
-    Scheduler.Init();
+    PROFILE_CALLBACK(PROFILE_INIT_SCHEDULER);
+    SIM_LOG("InitScheduler(): Initializing scheduler", 4);
+    if(CurrentContext->policy == nullptr) {
+        CurrentContext->policy = Scheduler_DefaultPolicy();
+    }
+    if(CurrentContext->policy == nullptr) {
+        ThrowException("InitScheduler(): Unknown scheduling policy, expected greedy, pmapper, balanced or minutil: ", getenv("CLOUDSIM_POLICY"));
+    }
+    SIM_LOG("InitScheduler(): Using the " + string(CurrentContext->policy->name) + " policy", 1);
+    CurrentContext->next_check = 0;
+    Trace_Init();
+    Trace_Record(TRACE_INIT, 0, 0);
+    CurrentContext->scheduler.reset(CurrentContext->policy->create());
+    CurrentContext->policy->init();
+    CurrentContext->sla_stats.Init();
+    CurrentContext->admission.Clear();
+
+    const char * metrics = getenv("CLOUDSIM_METRICS");
+    const char * interval = getenv("CLOUDSIM_METRICS_INTERVAL");
+    CurrentContext->metrics.reset();
+    if(metrics != nullptr && *metrics != '\0') {
+        CurrentContext->metrics.reset(new MetricsRecorder(metrics, interval != nullptr ? strtoull(interval, nullptr, 10) : 1000000));
+    }
 }
 
 void HandleNewTask(Time_t time, TaskId_t task_id) {
-    SimOutput("HandleNewTask(): Received new task " + to_string(task_id) + " at time " + to_string(time), 4);
-    Scheduler.NewTask(time, task_id);
+    PROFILE_CALLBACK(PROFILE_HANDLE_NEW_TASK);
+    SIM_LOG("HandleNewTask(): Received new task " + to_string(task_id) + " at time " + to_string(time), 4);
+    Trace_Record(TRACE_NEW_TASK, time, task_id);
+    CurrentContext->policy->new_task(time, task_id);
+    Scheduler_AdmitOrQueue(task_id);
+}
+
+void HandleNewTasks(Time_t time, const TaskId_t * task_ids, unsigned count) {
+    PROFILE_CALLBACK(PROFILE_HANDLE_NEW_TASKS);
+    SIM_LOG("HandleNewTasks(): Received " + to_string(count) + " new tasks at time " + to_string(time), 4);
+    for(unsigned i = 0; i < count; i++) {
+        Trace_Record(TRACE_NEW_TASK, time, task_ids[i]);
+    }
+    if(CurrentContext->policy->new_tasks == nullptr) {
+        for(unsigned i = 0; i < count; i++) {
+            CurrentContext->policy->new_task(time, task_ids[i]);
+            Scheduler_AdmitOrQueue(task_ids[i]);
+        }
+        return;
+    }
+    CurrentContext->policy->new_tasks(time, task_ids, count);
+    for(unsigned i = 0; i < count; i++) {
+        Scheduler_AdmitOrQueue(task_ids[i]);
+    }
 }
 
 void HandleTaskCompletion(Time_t time, TaskId_t task_id) {
-    SimOutput("HandleTaskCompletion(): Task " + to_string(task_id) + " completed at time " + to_string(time), 4);
-    Scheduler.TaskComplete(time, task_id);
+    PROFILE_CALLBACK(PROFILE_HANDLE_TASK_COMPLETION);
+    SIM_LOG("HandleTaskCompletion(): Task " + to_string(task_id) + " completed at time " + to_string(time), 4);
+    Trace_Record(TRACE_TASK_COMPLETION, time, task_id);
+    CurrentContext->sla_stats.TaskCompleted(task_id, time);
+    CurrentContext->policy->task_complete(time, task_id);
+    CurrentContext->admission.Release();
 }
 
 void MemoryWarning(Time_t time, MachineId_t machine_id) {
+    PROFILE_CALLBACK(PROFILE_MEMORY_WARNING);
     // The simulator is alerting you that machine identified by machine_id is overcommitted
-    SimOutput("MemoryWarning(): Overflow at " + to_string(machine_id) + " was detected at time " + to_string(time), 0);
+    SIM_LOG("MemoryWarning(): Overflow at " + to_string(machine_id) + " was detected at time " + to_string(time), 0);
+    Trace_Record(TRACE_MEMORY_WARNING, time, machine_id);
 }
 
 void MigrationDone(Time_t time, VMId_t vm_id) {
+    PROFILE_CALLBACK(PROFILE_MIGRATION_DONE);
     // The function is called on to alert you that migration is complete
-    SimOutput("MigrationDone(): Migration of VM " + to_string(vm_id) + " was completed at time " + to_string(time), 4);
-    Scheduler.MigrationComplete(time, vm_id);
-    migrating = false;
+    SIM_LOG("MigrationDone(): Migration of VM " + to_string(vm_id) + " was completed at time " + to_string(time), 4);
+    Trace_Record(TRACE_MIGRATION_DONE, time, vm_id);
+    CurrentContext->policy->migration_complete(time, vm_id);
+    CurrentContext->migrating = false;
+    CurrentContext->admission.Drain(time);
 }
 
 void SchedulerCheck(Time_t time) {
+    PROFILE_CALLBACK(PROFILE_SCHEDULER_CHECK);
     // This function is called periodically by the simulator, no specific event
-    SimOutput("SchedulerCheck(): SchedulerCheck() called at " + to_string(time), 4);
-    Scheduler.PeriodicCheck(time);
+    SIM_LOG("SchedulerCheck(): SchedulerCheck() called at " + to_string(time), 4);
+    Trace_Record(TRACE_SCHEDULER_CHECK, time, 0);
+    if(CurrentContext->metrics) {
+        CurrentContext->metrics->Sample(time);
+    }
+    CurrentContext->admission.DrainReleased(time);
+    // Ticks that fall inside the policy's check interval are coalesced
+    Time_t check_interval = CurrentContext->policy->check_interval;
+    if(check_interval == NO_PERIODIC_CHECK || time < CurrentContext->next_check) {
+        return;
+    }
+    CurrentContext->next_check = time + check_interval;
+    CurrentContext->policy->periodic_check(time);
     // static unsigned counts = 0;
     // counts++;
     // if(counts == 10) {
@@ -188,6 +148,7 @@ void SchedulerCheck(Time_t time) {
 }
 
 void SimulationComplete(Time_t time) {
+    PROFILE_CALLBACK(PROFILE_SIMULATION_COMPLETE);
     // This function is called before the simulation terminates Add whatever you feel like.
     cout << "SLA violation report" << endl;
     cout << "SLA0: " << GetSLAReport(SLA0) << "%" << endl;
@@ -195,16 +156,35 @@ void SimulationComplete(Time_t time) {
     cout << "SLA2: " << GetSLAReport(SLA2) << "%" << endl;     // SLA3 do not have SLA violation issues
     cout << "Total Energy " << Machine_GetClusterEnergy() << "KW-Hour" << endl;
     cout << "Simulation run finished in " << double(time)/1000000 << " seconds" << endl;
-    SimOutput("SimulationComplete(): Simulation finished at time " + to_string(time), 4);
-
-    Scheduler.Shutdown(time);
+    SIM_LOG("SimulationComplete(): Simulation finished at time " + to_string(time), 4);
+    const SLAStats & sla_stats = CurrentContext->sla_stats;
+    for(SLAType_t sla : {SLA0, SLA1, SLA2, SLA3}) {
+        SIM_LOG("SimulationComplete(): SLA" + to_string(sla) + " " + to_string(sla_stats.Counters(sla).completed) + " completed, " +
+                to_string(sla_stats.ViolationRate(sla)) + "% violated, slowdown p50 " + to_string(sla_stats.SlowdownQuantile(sla, 0.5)) +
+                " p99 " + to_string(sla_stats.SlowdownQuantile(sla, 0.99)), 1);
+    }
+    SIM_LOG("SimulationComplete(): " + to_string(CurrentContext->admission.Size()) + " tasks still waiting for admission", 1);
+
+    CurrentContext->policy->shutdown(time);
+    Trace_Record(TRACE_SIMULATION_COMPLETE, time, 0);
+    Trace_Flush();
+    if(CurrentContext->metrics) {
+        CurrentContext->metrics->Sample(time, true);
+        CurrentContext->metrics.reset();
+    }
+    PROFILE_REPORT();
 }
 
 void SLAWarning(Time_t time, TaskId_t task_id) {
-
+    PROFILE_CALLBACK(PROFILE_SLA_WARNING);
+    Trace_Record(TRACE_SLA_WARNING, time, task_id);
+    CurrentContext->sla_stats.TaskWarned(task_id);
 }
 
 void StateChangeComplete(Time_t time, MachineId_t machine_id) {
+    PROFILE_CALLBACK(PROFILE_STATE_CHANGE_COMPLETE);
     // Called in response to an earlier request to change the state of a machine
+    Trace_Record(TRACE_STATE_CHANGE_COMPLETE, time, machine_id);
+    CurrentContext->policy->state_change_complete(time, machine_id);
+    CurrentContext->admission.Drain(time);
 }
-
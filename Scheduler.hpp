@@ -8,26 +8,55 @@
 #ifndef Scheduler_hpp
 #define Scheduler_hpp
 
+#include <string>
 #include <vector>
 
+#include "CapacityIndex.hpp"
 #include "Interfaces.h"
+#include "MachineView.h"
+#include "PlacementIndex.hpp"
+#include "UtilizationStats.hpp"
 
+// State shared by every policy, the policies in Algorithms/ derive from it
 class Scheduler {
 public:
     Scheduler()                 {}
-    void Init();
-    void MigrationComplete(Time_t time, VMId_t vm_id);
-    void NewTask(Time_t now, TaskId_t task_id);
-    void PeriodicCheck(Time_t now);
-    void Shutdown(Time_t now);
-    void TaskComplete(Time_t now, TaskId_t task_id);
-    float CalculateUtilizationImbalance(MachineId_t simulated_machine, float simulated_utilization);
-    VMId_t GetSmallestVMOnMachine(MachineId_t machine_id);
-    MachineId_t FindBestMachineForVM(VMId_t vm_id);
+    virtual ~Scheduler()        {}
     vector<VMId_t> vms;
     vector<MachineId_t> machines;
+    PlacementIndex index;       // Kept current from NewTask, TaskComplete, MigrationComplete and Shutdown
+    UtilizationStats utilization_stats;
+    CapacityIndex capacity;     // Updated wherever a machine view is invalidated
 };
 
+#define NO_PERIODIC_CHECK   ((Time_t) -1)
 
+// One entry per policy. The hooks are instantiated for the concrete policy class by PolicyHooks, so the
+// only indirection per event is the call through this table.
+typedef struct {
+    const char * name;
+    Time_t check_interval;      // Minimum time between periodic checks, 0 for every tick, NO_PERIODIC_CHECK for none
+    Scheduler * (*create)();
+    void (*init)();
+    void (*new_task)(Time_t time, TaskId_t task_id);
+    void (*new_tasks)(Time_t time, const TaskId_t * task_ids, unsigned count);     // nullptr places a burst one task at a time
+    void (*task_complete)(Time_t time, TaskId_t task_id);
+    void (*migration_complete)(Time_t time, VMId_t vm_id);
+    void (*periodic_check)(Time_t time);
+    void (*state_change_complete)(Time_t time, MachineId_t machine_id);
+    void (*shutdown)(Time_t time);
+} SchedulerPolicy_t;
+
+extern const SchedulerPolicy_t GreedyPolicy;        // Algorithms/Scheduler.cpp
+extern const SchedulerPolicy_t PMapperPolicy;       // Algorithms/Scheduler2.cpp
+extern const SchedulerPolicy_t BalancedPolicy;      // Algorithms/Scheduler3.cpp
+extern const SchedulerPolicy_t MinUtilPolicy;       // Algorithms/Scheduler4.cpp
+
+extern const SchedulerPolicy_t * Scheduler_FindPolicy(const string & name);     // nullptr for unknown names
+extern const SchedulerPolicy_t * Scheduler_DefaultPolicy();                     // $CLOUDSIM_POLICY, greedy if unset
+
+// A burst of arrivals within the arrival window. The prebuilt simulator only calls HandleNewTask(), so this entry
+// point and the policies' new_tasks hooks are reached from Bench/bench -w alone.
+extern void HandleNewTasks(Time_t time, const TaskId_t * task_ids, unsigned count);
 
 #endif /* Scheduler_hpp */
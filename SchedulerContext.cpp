@@ -0,0 +1,29 @@
+//
+//  SchedulerContext.cpp
+//  CloudSim
+//
+
+#include "SchedulerContext.hpp"
+
+static SchedulerContext DefaultContext;
+thread_local SchedulerContext * CurrentContext = &DefaultContext;
+
+void SchedulerContext_Bind(SchedulerContext * context) {
+    CurrentContext = context != nullptr ? context : &DefaultContext;
+}
+
+// VM Interface, non-allocating accessors served from the placement index of the current context
+
+static const vector<TaskId_t> NoTasks;
+
+MachineId_t VM_GetMachine(VMId_t vm_id) {
+    return CurrentContext->scheduler ? CurrentContext->scheduler->index.VMMachine(vm_id) : NO_MACHINE;
+}
+
+unsigned VM_GetTaskCount(VMId_t vm_id) {
+    return CurrentContext->scheduler ? CurrentContext->scheduler->index.VMTaskCount(vm_id) : 0;
+}
+
+const vector<TaskId_t> & VM_GetTasks(VMId_t vm_id) {
+    return CurrentContext->scheduler ? CurrentContext->scheduler->index.VMTasks(vm_id) : NoTasks;
+}
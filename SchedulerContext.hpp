@@ -0,0 +1,76 @@
+//
+//  SchedulerContext.hpp
+//  CloudSim
+//
+//  Owns everything the scheduler keeps between callbacks: the policy's Scheduler object, its flags and the
+//  machine and task views. The hooks reach it through the context bound to the calling thread, so independent
+//  runs can share a process as long as each stays on its own thread. The Machine, VM, Task and Simulator modules keep
+//  their own global tables and are outside of the context.
+//
+
+#ifndef SchedulerContext_hpp
+#define SchedulerContext_hpp
+
+#include <memory>
+
+#include "AdmissionQueue.hpp"
+#include "MachineView.h"
+#include "MetricsRecorder.hpp"
+#include "Profiler.h"
+#include "SLAStats.hpp"
+#include "Scheduler.hpp"
+#include "SchedulerLog.h"
+#include "TaskView.h"
+
+class SchedulerContext {
+public:
+    SchedulerContext()          {}
+    const SchedulerPolicy_t * policy = nullptr;     // Chosen by InitScheduler() unless set beforehand
+    unique_ptr<Scheduler> scheduler;                // Created by InitScheduler() for the policy
+    bool migrating = false;
+    unsigned active_machines = 16;
+    Time_t next_check = 0;                          // SchedulerCheck() skips the policy until then
+    MachineViewTable_t machine_views;
+    TaskViewTable_t task_views;
+    AdmissionQueue admission;                       // Tasks waiting for capacity
+    SLAStats sla_stats;                             // Maintained by the hooks, readable by the policy
+    TraceRing_t trace = {};
+    ProfileTable_t profile = {};
+    unique_ptr<MetricsRecorder> metrics;           // Only while CLOUDSIM_METRICS is set
+};
+
+extern thread_local SchedulerContext * CurrentContext;             // Starts out bound to a process-wide default context
+extern void SchedulerContext_Bind(SchedulerContext * context);      // Binds the calling thread, nullptr restores the default
+
+inline Scheduler & CurrentScheduler()   { return *CurrentContext->scheduler; }
+
+// Non-allocating VM accessors served from the placement index of the current context. They reflect the VMs and tasks
+// placed through the scheduler, before InitScheduler() every VM reads as unattached and empty.
+extern MachineId_t                  VM_GetMachine(VMId_t vm_id);
+extern unsigned                     VM_GetTaskCount(VMId_t vm_id);
+extern const vector<TaskId_t> &     VM_GetTasks(VMId_t vm_id);
+
+// Instantiates the scheduler hooks for one policy class. Policy derives from Scheduler and provides Init,
+// NewTask, TaskComplete, MigrationComplete, PeriodicCheck, StateChangeComplete and Shutdown. Policies that
+// place bursts of arrivals together also provide NewTasks and pass the NewTasks hook to Describe().
+template <class Policy>
+class PolicyHooks {
+public:
+    static Policy & Current()                                               { return static_cast<Policy &>(CurrentScheduler()); }
+    static Scheduler * Create()                                             { return new Policy(); }
+    static void Init()                                                      { Current().Init(); }
+    static void NewTask(Time_t time, TaskId_t task_id)                      { Current().NewTask(time, task_id); }
+    static void NewTasks(Time_t time, const TaskId_t * task_ids, unsigned count)    { Current().NewTasks(time, task_ids, count); }
+    static void TaskComplete(Time_t time, TaskId_t task_id)                 { Current().TaskComplete(time, task_id); }
+    static void MigrationComplete(Time_t time, VMId_t vm_id)                { Current().MigrationComplete(time, vm_id); }
+    static void PeriodicCheck(Time_t time)                                  { Current().PeriodicCheck(time); }
+    static void StateChangeComplete(Time_t time, MachineId_t machine_id)    { Current().StateChangeComplete(time, machine_id); }
+    static void Shutdown(Time_t time)                                       { Current().Shutdown(time); }
+
+    static constexpr SchedulerPolicy_t Describe(const char * name, Time_t check_interval,
+                                                void (*new_tasks)(Time_t, const TaskId_t *, unsigned) = nullptr) {
+        return {name, check_interval, Create, Init, NewTask, new_tasks, TaskComplete, MigrationComplete, PeriodicCheck, StateChangeComplete, Shutdown};
+    }
+};
+
+#endif /* SchedulerContext_hpp */
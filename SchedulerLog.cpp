@@ -0,0 +1,161 @@
+//
+//  SchedulerLog.cpp
+//  CloudSim
+//
+
+#include <algorithm>
+#include <climits>
+#include <cstdlib>
+
+#include "SchedulerContext.hpp"
+#include "SchedulerLog.h"
+
+#define TRACE_DEFAULT_RECORDS   (1 << 20)
+
+#define LOG_DEFAULT_LEVEL       UINT_MAX        // Every message reaches SimOutput(), which applies -v
+
+static unsigned ReadLevel() {
+    const char * level = getenv("CLOUDSIM_VERBOSE");
+    return level != nullptr ? unsigned(atoi(level)) : LOG_DEFAULT_LEVEL;
+}
+
+unsigned SchedulerLog_Level = ReadLevel();
+
+static FILE * OpenTrace(const char * path) {
+    FILE * file = fopen(path, "wb");
+    if(file == nullptr) {
+        ThrowException("Trace: Cannot open trace file ", path);
+    }
+    return file;
+}
+
+// Records [from, to) of the ring, oldest first
+static void WriteRecords(TraceRing_t & trace, uint64_t from, uint64_t to) {
+    uint64_t size = trace.records.size();
+    while(from < to) {
+        uint64_t slot = from % size;
+        uint64_t run = min(size - slot, to - from);
+        fwrite(&trace.records[slot], sizeof(TraceRecord_t), run, trace.file);
+        from += run;
+    }
+}
+
+void Trace_Init() {
+    TraceRing_t & trace = CurrentContext->trace;
+    if(trace.file != nullptr) {
+        fclose(trace.file);
+    }
+    trace = TraceRing_t();
+    const char * path = getenv("CLOUDSIM_TRACE");
+    if(path == nullptr) {
+        return;
+    }
+    const char * records = getenv("CLOUDSIM_TRACE_RECORDS");
+    unsigned size = records != nullptr ? unsigned(atoi(records)) : TRACE_DEFAULT_RECORDS;
+    trace.records.resize(size > 0 ? size : 1);
+    if(getenv("CLOUDSIM_TRACE_ALL") != nullptr) {
+        // The header is rewritten with the record count when the trace is flushed
+        TraceHeader_t header = {TRACE_MAGIC, 0, 0};
+        trace.file = OpenTrace(path);
+        fwrite(&header, sizeof(header), 1, trace.file);
+    }
+}
+
+void Trace_Record(TraceEvent_t event, Time_t time, uint32_t id, uint32_t arg, uint32_t arg2) {
+    TraceRing_t & trace = CurrentContext->trace;
+    if(trace.records.empty()) {
+        return;
+    }
+    if(trace.file != nullptr && trace.written - trace.spilled == trace.records.size()) {
+        WriteRecords(trace, trace.spilled, trace.written);
+        trace.spilled = trace.written;
+    }
+    trace.records[trace.written % trace.records.size()] = {time, uint32_t(event), id, arg, arg2};
+    trace.written++;
+}
+
+void Trace_Flush() {
+    TraceRing_t & trace = CurrentContext->trace;
+    if(trace.records.empty()) {
+        return;
+    }
+    if(trace.file == nullptr) {
+        uint64_t kept = min<uint64_t>(trace.written, trace.records.size());
+        TraceHeader_t header = {TRACE_MAGIC, kept, trace.written - kept};
+        trace.file = OpenTrace(getenv("CLOUDSIM_TRACE"));
+        fwrite(&header, sizeof(header), 1, trace.file);
+        WriteRecords(trace, trace.written - kept, trace.written);
+    }
+    else {
+        TraceHeader_t header = {TRACE_MAGIC, trace.written, 0};
+        WriteRecords(trace, trace.spilled, trace.written);
+        fseek(trace.file, 0, SEEK_SET);
+        fwrite(&header, sizeof(header), 1, trace.file);
+    }
+    fclose(trace.file);
+    trace.file = nullptr;
+    trace.spilled = trace.written;
+}
+
+// Scheduler actions
+
+static bool Tracing() {
+    return !CurrentContext->trace.records.empty();
+}
+
+VMId_t Traced_VMCreate(VMType_t vm_type, CPUType_t cpu) {
+    PROFILE_SCOPE(PROFILE_VM_CREATE);
+    VMId_t vm_id = VM_Create(vm_type, cpu);
+    if(Tracing()) {
+        Trace_Record(TRACE_VM_CREATE, Now(), vm_id, vm_type, cpu);
+    }
+    return vm_id;
+}
+
+void Traced_VMAttach(VMId_t vm_id, MachineId_t machine_id) {
+    PROFILE_SCOPE(PROFILE_VM_ATTACH);
+    if(Tracing()) {
+        Trace_Record(TRACE_VM_ATTACH, Now(), vm_id, machine_id);
+    }
+    VM_Attach(vm_id, machine_id);
+}
+
+void Traced_VMAddTask(VMId_t vm_id, TaskId_t task_id, Priority_t priority) {
+    PROFILE_SCOPE(PROFILE_VM_ADD_TASK);
+    if(Tracing()) {
+        Trace_Record(TRACE_VM_ADD_TASK, Now(), vm_id, task_id, priority);
+    }
+    VM_AddTask(vm_id, task_id, priority);
+}
+
+void Traced_VMMigrate(VMId_t vm_id, MachineId_t machine_id) {
+    PROFILE_SCOPE(PROFILE_VM_MIGRATE);
+    if(Tracing()) {
+        Trace_Record(TRACE_VM_MIGRATE, Now(), vm_id, machine_id);
+    }
+    VM_Migrate(vm_id, machine_id);
+}
+
+void Traced_VMShutdown(VMId_t vm_id) {
+    PROFILE_SCOPE(PROFILE_VM_SHUTDOWN);
+    if(Tracing()) {
+        Trace_Record(TRACE_VM_SHUTDOWN, Now(), vm_id);
+    }
+    VM_Shutdown(vm_id);
+}
+
+void Traced_MachineSetState(MachineId_t machine_id, MachineState_t s_state) {
+    PROFILE_SCOPE(PROFILE_MACHINE_SET_STATE);
+    if(Tracing()) {
+        Trace_Record(TRACE_MACHINE_SET_STATE, Now(), machine_id, s_state);
+    }
+    Machine_SetState(machine_id, s_state);
+}
+
+void Traced_MachineSetCorePerformance(MachineId_t machine_id, unsigned core_id, CPUPerformance_t p_state) {
+    PROFILE_SCOPE(PROFILE_MACHINE_SET_CORE_PERFORMANCE);
+    if(Tracing()) {
+        Trace_Record(TRACE_MACHINE_SET_CORE_PERFORMANCE, Now(), machine_id, core_id, p_state);
+    }
+    Machine_SetCorePerformance(machine_id, core_id, p_state);
+}
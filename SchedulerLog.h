@@ -0,0 +1,99 @@
+//
+//  SchedulerLog.h
+//  CloudSim
+//
+//  Logging and tracing for the scheduler. SIM_LOG() tests the level before the message expression is evaluated,
+//  so a disabled message costs a compare instead of the to_string() calls and concatenations that build it.
+//  By default every message is passed on and SimOutput() filters it by the simulator's -v level, which main keeps
+//  private. CLOUDSIM_VERBOSE sets the scheduler's own threshold, messages above it are never formatted.
+//
+//  The trace is a fixed-size ring of binary records kept in the SchedulerContext, one per scheduler callback and
+//  one per action the scheduler takes through the Traced_*() wrappers. It is off unless CLOUDSIM_TRACE names a
+//  file, CLOUDSIM_TRACE_RECORDS sets the ring size (1M records by default). By default the ring keeps the most
+//  recent records and is written out when the simulation completes, oldest record first, behind a TraceHeader_t.
+//  With CLOUDSIM_TRACE_ALL set the ring is spilled to the file whenever it fills, so every record is kept without
+//  holding the run in memory. Tools/tracediff decodes and compares trace files.
+//
+
+#ifndef SchedulerLog_h
+#define SchedulerLog_h
+
+#include <cstdint>
+#include <cstdio>
+#include <vector>
+
+#include "Interfaces.h"
+
+extern unsigned SchedulerLog_Level;
+
+#define SIM_LOG(message, level) \
+    do { if((level) <= SchedulerLog_Level) { SimOutput(message, level); } } while(0)
+
+typedef enum {
+    TRACE_INIT,
+    TRACE_NEW_TASK,
+    TRACE_TASK_COMPLETION,
+    TRACE_MEMORY_WARNING,
+    TRACE_MIGRATION_DONE,
+    TRACE_SCHEDULER_CHECK,
+    TRACE_SIMULATION_COMPLETE,
+    TRACE_SLA_WARNING,
+    TRACE_STATE_CHANGE_COMPLETE,
+
+    // Scheduler actions
+    TRACE_VM_CREATE,                        // id VM, arg VM type, arg2 CPU type
+    TRACE_VM_ATTACH,                        // id VM, arg machine
+    TRACE_VM_ADD_TASK,                      // id VM, arg task, arg2 priority
+    TRACE_VM_MIGRATE,                       // id VM, arg destination machine
+    TRACE_VM_SHUTDOWN,                      // id VM
+    TRACE_MACHINE_SET_STATE,                // id machine, arg S-state
+    TRACE_MACHINE_SET_CORE_PERFORMANCE      // id machine, arg core, arg2 P-state
+} TraceEvent_t;
+#define TRACE_EVENTS (TRACE_MACHINE_SET_CORE_PERFORMANCE + 1)
+
+inline const char * Trace_EventName(uint32_t event) {
+    static const char * names[TRACE_EVENTS] = {
+        "Init", "NewTask", "TaskCompletion", "MemoryWarning", "MigrationDone", "SchedulerCheck", "SimulationComplete",
+        "SLAWarning", "StateChangeComplete", "VM_Create", "VM_Attach", "VM_AddTask", "VM_Migrate", "VM_Shutdown",
+        "Machine_SetState", "Machine_SetCorePerformance"
+    };
+    return event < TRACE_EVENTS ? names[event] : "Unknown";
+}
+
+#define TRACE_MAGIC     0x32454341525453ULL     // "STRACE2"
+
+typedef struct {
+    uint64_t magic;
+    uint64_t records;                       // Records that follow the header
+    uint64_t dropped;                       // Older records overwritten in the ring
+} TraceHeader_t;
+
+typedef struct {
+    uint64_t time;
+    uint32_t event;                         // TraceEvent_t
+    uint32_t id;                            // Task, VM or machine the record is about, 0 if none
+    uint32_t arg;
+    uint32_t arg2;
+} TraceRecord_t;
+
+typedef struct {
+    vector<TraceRecord_t> records;          // Empty when tracing is off
+    uint64_t written;                       // Records ever written, the ring keeps the last records.size()
+    uint64_t spilled;                       // Records already written to the file
+    FILE * file;                            // Open while spilling with CLOUDSIM_TRACE_ALL
+} TraceRing_t;                              // Owned by the SchedulerContext
+
+extern void Trace_Init();                                                   // Call from InitScheduler()
+extern void Trace_Record(TraceEvent_t event, Time_t time, uint32_t id, uint32_t arg = 0, uint32_t arg2 = 0);
+extern void Trace_Flush();                                                  // Writes the ring to $CLOUDSIM_TRACE
+
+// Scheduler actions, forwarded to the Machine and VM modules and recorded in the trace
+extern VMId_t Traced_VMCreate(VMType_t vm_type, CPUType_t cpu);
+extern void Traced_VMAttach(VMId_t vm_id, MachineId_t machine_id);
+extern void Traced_VMAddTask(VMId_t vm_id, TaskId_t task_id, Priority_t priority);
+extern void Traced_VMMigrate(VMId_t vm_id, MachineId_t machine_id);
+extern void Traced_VMShutdown(VMId_t vm_id);
+extern void Traced_MachineSetState(MachineId_t machine_id, MachineState_t s_state);
+extern void Traced_MachineSetCorePerformance(MachineId_t machine_id, unsigned core_id, CPUPerformance_t p_state);
+
+#endif /* SchedulerLog_h */
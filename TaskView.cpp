@@ -0,0 +1,53 @@
+//
+//  TaskView.cpp
+//  CloudSim
+//
+
+#include "Interfaces.h"
+#include "SchedulerContext.hpp"
+#include "TaskView.h"
+
+static void Fetch(TaskPlacementAttrs_t & attrs, TaskId_t task_id) {
+    PROFILE_SCOPE(PROFILE_GET_TASK_INFO);
+    TaskInfo_t info = GetTaskInfo(task_id);
+    attrs.memory = info.required_memory;
+    attrs.cpu = info.required_cpu;
+    attrs.vm_type = info.required_vm;
+    attrs.sla = info.required_sla;
+    attrs.arrival = info.arrival;
+    attrs.target_completion = info.target_completion;
+    attrs.gpu_capable = info.gpu_capable;
+    attrs.known = true;
+}
+
+void TaskView_Init() {
+    vector<TaskPlacementAttrs_t> & attrs = CurrentContext->task_views.attrs;
+    attrs.clear();
+    attrs.resize(GetNumTasks(), TaskPlacementAttrs_t());
+}
+
+const TaskPlacementAttrs_t & Task_GetPlacementAttrs(TaskId_t task_id) {
+    vector<TaskPlacementAttrs_t> & table = CurrentContext->task_views.attrs;
+    if(task_id >= table.size()) {
+        table.resize(task_id + 1, TaskPlacementAttrs_t());
+    }
+    TaskPlacementAttrs_t & attrs = table[task_id];
+    if(!attrs.known) {
+        Fetch(attrs, task_id);
+    }
+    return attrs;
+}
+
+void Task_GetPlacementAttrs(const TaskId_t * task_ids, unsigned count, TaskPlacementAttrs_t * attrs) {
+    for(unsigned i = 0; i < count; i++) {
+        attrs[i] = Task_GetPlacementAttrs(task_ids[i]);
+    }
+}
+
+unsigned Task_GetTotalMemory(const vector<TaskId_t> & task_ids) {
+    unsigned total = 0;
+    for(TaskId_t task_id : task_ids) {
+        total += Task_GetPlacementAttrs(task_id).memory;
+    }
+    return total;
+}
@@ -0,0 +1,39 @@
+//
+//  TaskView.h
+//  CloudSim
+//
+//  Packed copy of the task attributes that placement reads. The Task module only answers one field per call,
+//  or copies the whole TaskInfo_t with its instruction counts and timestamps. The view fetches a task once,
+//  through GetTaskInfo(), and keeps the placement fields of every task side by side so that loops over many
+//  tasks stay within a few cache lines. The fields never change after arrival, so there is no invalidation.
+//
+
+#ifndef TaskView_h
+#define TaskView_h
+
+#include <vector>
+
+#include "SimTypes.h"
+
+typedef struct {
+    unsigned memory;                        // Memory required by the task, without the VM overhead
+    CPUType_t cpu;                          // CPU type the task has to run on
+    VMType_t vm_type;                       // VM type the task has to run in
+    SLAType_t sla;
+    Time_t arrival;
+    Time_t target_completion;               // Deadline of the SLA
+    bool gpu_capable;
+    bool known;                             // The entry was fetched from the Task module
+} TaskPlacementAttrs_t;
+
+typedef struct {
+    vector<TaskPlacementAttrs_t> attrs;     // Indexed by TaskId_t, grown on demand
+} TaskViewTable_t;                          // Owned by the SchedulerContext
+
+extern void                         TaskView_Init();                                // Call from InitScheduler()
+
+extern const TaskPlacementAttrs_t & Task_GetPlacementAttrs(TaskId_t task_id);           // Valid until a later task is first fetched
+extern void                         Task_GetPlacementAttrs(const TaskId_t * task_ids, unsigned count, TaskPlacementAttrs_t * attrs);
+extern unsigned                     Task_GetTotalMemory(const vector<TaskId_t> & task_ids);
+
+#endif /* TaskView_h */
@@ -0,0 +1,47 @@
+//
+//  RunStat.cpp
+//  CloudSim
+//
+//  Runs a command with its output discarded and prints its wall time and peak resident set size, for the
+//  scaling target of the Makefile.
+//
+//  usage: runstat command [arguments]
+//
+
+#include <chrono>
+#include <fcntl.h>
+#include <iostream>
+#include <sys/resource.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+using namespace std;
+
+int main(int argc, char * argv[]) {
+    if(argc < 2) {
+        cerr << "usage: " << argv[0] << " command [arguments]" << endl;
+        return 2;
+    }
+    auto start = chrono::steady_clock::now();
+    pid_t pid = fork();
+    if(pid == 0) {
+        int null = open("/dev/null", O_WRONLY);
+        dup2(null, STDOUT_FILENO);
+        execvp(argv[1], argv + 1);
+        _exit(127);
+    }
+    int status;
+    struct rusage usage;
+    if(pid < 0 || wait4(pid, &status, 0, &usage) < 0) {
+        cerr << argv[0] << ": cannot run " << argv[1] << endl;
+        return 2;
+    }
+    double wall_seconds = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+#ifdef __APPLE__
+    long max_rss_kb = usage.ru_maxrss / 1024;       // Bytes on macOS
+#else
+    long max_rss_kb = usage.ru_maxrss;
+#endif
+    cout << wall_seconds << " " << max_rss_kb << endl;
+    return WIFEXITED(status) ? WEXITSTATUS(status) : 1;
+}
@@ -0,0 +1,170 @@
+//
+//  ScenarioGen.cpp
+//  CloudSim
+//
+//  Writes a scenario in the format Init() reads (see Input.md) for clusters far larger than the ones in inputs/.
+//  The machines are split evenly between the machine classes, which cycle through the CPU types with and without
+//  GPUs. There is one task class stream per CPU type in the cluster, so every task has a machine it can run on,
+//  and the arrival rate grows with the cluster to keep the load per machine the same.
+//
+//  Arrival processes, built from task classes since each class arrives at a fixed mean rate between its start and
+//  end times:
+//      poisson     one class per stream over the whole run
+//      diurnal     DIURNAL_SEGMENTS classes per stream whose rate follows a sine over -p period
+//      bursty      a light background per stream plus bursts at 30x the rate, like Spikey-1 and Spikey2
+//
+//  usage: scenariogen [-m machines] [-k machine classes] [-d duration] [-a poisson|diurnal|bursty] [-i inter arrival]
+//                     [-p period] [-s seed]
+//
+
+#include <cmath>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <string>
+
+#include "../SimTypes.h"
+
+#define DIURNAL_SEGMENTS    24
+#define BURSTS              4
+#define BURST_FACTOR        30
+
+typedef struct {
+    const char * cpu;
+    unsigned cores;
+    unsigned memory;
+    const char * s_states;
+    const char * p_states;
+    const char * c_states;
+    const char * mips;
+} MachineTemplate_t;
+
+static const MachineTemplate_t MachineTemplates[] = {
+    {"X86",   8,  16384, "[120, 100, 100, 80, 40, 10, 0]", "[12, 8, 6, 4]", "[12, 3, 1, 0]", "[3000, 2400, 2000, 1500]"},
+    {"ARM",   16, 16384, "[120, 100, 100, 80, 40, 10, 0]", "[12, 8, 6, 4]", "[12, 3, 1, 0]", "[1000, 800, 600, 400]"},
+    {"POWER", 8,  32768, "[250, 200, 200, 150, 80, 20, 0]", "[18, 12, 9, 6]", "[16, 4, 2, 0]", "[4000, 3200, 2400, 1600]"},
+    {"RISCV", 4,  8192,  "[40, 20, 16, 12, 10, 4, 0]", "[4, 2, 2, 1]", "[4, 1, 1, 0]", "[800, 600, 400, 200]"},
+};
+#define MACHINE_TEMPLATES (sizeof(MachineTemplates) / sizeof(MachineTemplates[0]))
+
+typedef struct {
+    const char * cpu;
+    Time_t runtime;
+    unsigned memory;
+    const char * vm_type;
+    const char * sla;
+    const char * task_type;
+} TaskTemplate_t;
+
+// One per machine template, in the same order
+static const TaskTemplate_t TaskTemplates[] = {
+    {"X86",   1000000, 8,   "LINUX",    "SLA0", "WEB"},
+    {"ARM",   2000000, 64,  "LINUX",    "SLA1", "STREAM"},
+    {"POWER", 4000000, 256, "AIX",      "SLA2", "CRYPTO"},
+    {"RISCV", 2000000, 32,  "LINUX_RT", "SLA3", "WEB"},
+};
+
+typedef struct {
+    unsigned machines;
+    unsigned machine_classes;
+    Time_t duration;
+    string arrivals;
+    Time_t inter_arrival;               // Per stream, 0 to scale with the cluster
+    Time_t period;                      // Diurnal period, 0 for the duration
+    unsigned seed;
+} GenConfig_t;
+
+static void MachineClass(const MachineTemplate_t & machine, unsigned count, bool gpus) {
+    cout << "machine class:\n{\n"
+         << "        Number of machines: " << count << "\n"
+         << "        CPU type: " << machine.cpu << "\n"
+         << "        Number of cores: " << machine.cores << "\n"
+         << "        Memory: " << machine.memory << "\n"
+         << "        S-States: " << machine.s_states << "\n"
+         << "        P-States: " << machine.p_states << "\n"
+         << "        C-States: " << machine.c_states << "\n"
+         << "        MIPS: " << machine.mips << "\n"
+         << "        GPUs: " << (gpus ? "yes" : "no") << "\n"
+         << "}\n\n";
+}
+
+static void TaskClass(const TaskTemplate_t & task, Time_t start, Time_t end, Time_t inter_arrival, unsigned seed) {
+    cout << "task class:\n{\n"
+         << "        Start time: " << start << "\n"
+         << "        End time : " << end << "\n"
+         << "        Inter arrival: " << max<Time_t>(inter_arrival, 1) << "\n"
+         << "        Expected runtime: " << task.runtime << "\n"
+         << "        Memory: " << task.memory << "\n"
+         << "        VM type: " << task.vm_type << "\n"
+         << "        GPU enabled: no\n"
+         << "        SLA type: " << task.sla << "\n"
+         << "        CPU type: " << task.cpu << "\n"
+         << "        Task type: " << task.task_type << "\n"
+         << "        Seed: " << seed << "\n"
+         << "}\n\n";
+}
+
+static void Stream(const GenConfig_t & config, const TaskTemplate_t & task, Time_t inter_arrival, unsigned seed) {
+    Time_t start = 60000;
+    Time_t end = config.duration;
+    if(config.arrivals == "poisson") {
+        TaskClass(task, start, end, inter_arrival, seed);
+    }
+    else if(config.arrivals == "diurnal") {
+        Time_t period = config.period ? config.period : config.duration;
+        Time_t segment = max<Time_t>(period / DIURNAL_SEGMENTS, 1);
+        for(Time_t t = start; t < end; t += segment) {
+            double phase = 2 * M_PI * double(t % period) / period;
+            double rate = 1.0 + 0.8 * sin(phase);          // 0.2x to 1.8x the mean rate
+            TaskClass(task, t, min(t + segment, end), Time_t(inter_arrival / rate), seed++);
+        }
+    }
+    else {
+        TaskClass(task, start, end, inter_arrival * 2, seed++);
+        Time_t spacing = (end - start) / BURSTS;
+        for(unsigned i = 0; i < BURSTS; i++) {
+            Time_t burst_start = start + i * spacing + spacing / 2;
+            TaskClass(task, burst_start, burst_start + spacing / 10, inter_arrival / BURST_FACTOR, seed++);
+        }
+    }
+}
+
+int main(int argc, char * argv[]) {
+    GenConfig_t config = {1000, 4, 20000000, "poisson", 0, 0, 520230};
+    for(int i = 1; i + 1 < argc; i += 2) {
+        if(!strcmp(argv[i], "-m")) config.machines = atoi(argv[i + 1]);
+        else if(!strcmp(argv[i], "-k")) config.machine_classes = atoi(argv[i + 1]);
+        else if(!strcmp(argv[i], "-d")) config.duration = strtoull(argv[i + 1], nullptr, 10);
+        else if(!strcmp(argv[i], "-a")) config.arrivals = argv[i + 1];
+        else if(!strcmp(argv[i], "-i")) config.inter_arrival = strtoull(argv[i + 1], nullptr, 10);
+        else if(!strcmp(argv[i], "-p")) config.period = strtoull(argv[i + 1], nullptr, 10);
+        else if(!strcmp(argv[i], "-s")) config.seed = atoi(argv[i + 1]);
+        else {
+            cerr << "usage: " << argv[0] << " [-m machines] [-k machine classes] [-d duration] [-a poisson|diurnal|bursty]"
+                 << " [-i inter arrival] [-p period] [-s seed]" << endl;
+            return 1;
+        }
+    }
+    if(config.arrivals != "poisson" && config.arrivals != "diurnal" && config.arrivals != "bursty") {
+        cerr << argv[0] << ": unknown arrival process " << config.arrivals << ", expected poisson, diurnal or bursty" << endl;
+        return 1;
+    }
+    if(config.machines == 0 || config.machine_classes == 0 || config.machine_classes > config.machines) {
+        cerr << argv[0] << ": need at least one machine per machine class" << endl;
+        return 1;
+    }
+
+    // Machine classes take the remainder first, so the counts add up to the cluster size
+    unsigned streams = min<unsigned>(config.machine_classes, MACHINE_TEMPLATES);
+    for(unsigned i = 0; i < config.machine_classes; i++) {
+        unsigned count = config.machines / config.machine_classes + (i < config.machines % config.machine_classes);
+        MachineClass(MachineTemplates[i % MACHINE_TEMPLATES], count, (i / MACHINE_TEMPLATES) % 2 == 1);
+    }
+
+    // By default every machine sees a new task about every 2 seconds
+    Time_t inter_arrival = config.inter_arrival ? config.inter_arrival : Time_t(2000000) * streams / config.machines;
+    for(unsigned i = 0; i < streams; i++) {
+        Stream(config, TaskTemplates[i], inter_arrival, config.seed + 1000 * i);
+    }
+    return 0;
+}
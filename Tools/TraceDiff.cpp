@@ -0,0 +1,105 @@
+//
+//  TraceDiff.cpp
+//  CloudSim
+//
+//  Decodes and compares scheduler traces written with CLOUDSIM_TRACE (see SchedulerLog.h). Both files are
+//  memory-mapped and walked front to back, so traces much larger than memory are streamed through the page cache.
+//
+//  usage: tracediff trace               prints every record
+//         tracediff trace other         reports the first record where the two traces diverge
+//
+
+#include <algorithm>
+#include <fcntl.h>
+#include <iostream>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include "../SchedulerLog.h"
+
+#define CONTEXT_RECORDS 3
+
+typedef struct {
+    const TraceHeader_t * header;
+    const TraceRecord_t * records;
+    uint64_t count;
+} TraceFile_t;
+
+static bool Open(const char * path, TraceFile_t & trace) {
+    int fd = open(path, O_RDONLY);
+    struct stat st;
+    if(fd < 0 || fstat(fd, &st) != 0 || size_t(st.st_size) < sizeof(TraceHeader_t)) {
+        cerr << path << ": cannot read trace" << endl;
+        return false;
+    }
+    void * data = mmap(nullptr, st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd);
+    if(data == MAP_FAILED) {
+        cerr << path << ": cannot map trace" << endl;
+        return false;
+    }
+    madvise(data, st.st_size, MADV_SEQUENTIAL);
+    trace.header = (const TraceHeader_t *) data;
+    trace.records = (const TraceRecord_t *) (trace.header + 1);
+    trace.count = (st.st_size - sizeof(TraceHeader_t)) / sizeof(TraceRecord_t);
+    if(trace.header->magic != TRACE_MAGIC) {
+        cerr << path << ": not a scheduler trace" << endl;
+        return false;
+    }
+    if(trace.header->records < trace.count) {
+        trace.count = trace.header->records;
+    }
+    if(trace.header->dropped) {
+        cerr << path << ": " << trace.header->dropped << " older records were overwritten in the ring" << endl;
+    }
+    return true;
+}
+
+static void Print(const char * prefix, uint64_t index, const TraceRecord_t & record) {
+    cout << prefix << index << "\t" << record.time << "\t" << Trace_EventName(record.event)
+         << "\t" << record.id << "\t" << record.arg << "\t" << record.arg2 << endl;
+}
+
+static bool Same(const TraceRecord_t & a, const TraceRecord_t & b) {
+    return a.time == b.time && a.event == b.event && a.id == b.id && a.arg == b.arg && a.arg2 == b.arg2;
+}
+
+int main(int argc, char * argv[]) {
+    TraceFile_t first, second;
+    if(argc < 2 || argc > 3) {
+        cerr << "usage: " << argv[0] << " trace [other]" << endl;
+        return 2;
+    }
+    if(!Open(argv[1], first)) {
+        return 2;
+    }
+    if(argc == 2) {
+        for(uint64_t i = 0; i < first.count; i++) {
+            Print("", i, first.records[i]);
+        }
+        return 0;
+    }
+    if(!Open(argv[2], second)) {
+        return 2;
+    }
+
+    uint64_t common = min(first.count, second.count);
+    uint64_t i = 0;
+    while(i < common && Same(first.records[i], second.records[i])) {
+        i++;
+    }
+    if(i == first.count && i == second.count) {
+        cout << "identical, " << i << " records" << endl;
+        return 0;
+    }
+    cout << "first divergence at record " << i << endl;
+    for(uint64_t j = i > CONTEXT_RECORDS ? i - CONTEXT_RECORDS : 0; j < i; j++) {
+        Print("  ", j, first.records[j]);
+    }
+    if(i < first.count) Print("< ", i, first.records[i]);
+    else cout << "< end of " << argv[1] << endl;
+    if(i < second.count) Print("> ", i, second.records[i]);
+    else cout << "> end of " << argv[2] << endl;
+    return 1;
+}
@@ -0,0 +1,67 @@
+//
+//  UtilizationStats.cpp
+//  CloudSim
+//
+
+#include <cmath>
+
+#include "Profiler.h"
+#include "UtilizationStats.hpp"
+
+void UtilizationStats::Init(unsigned total_machines) {
+    utilization.assign(total_machines, 0.0f);
+    energy.assign(total_machines, 0);
+    machine_class.assign(total_machines, 0);
+    classes.clear();
+    for(unsigned i = 0; i < total_machines; i++) {
+        const MachineView_t & view = Machine_GetView(MachineId_t(i));
+        unsigned class_id = 0;
+        while(class_id < classes.size() &&
+              (classes[class_id].cpu != view.cpu || classes[class_id].memory_size != view.memory_size)) {
+            class_id++;
+        }
+        if(class_id == classes.size()) {
+            classes.push_back({view.cpu, view.memory_size, {}});
+        }
+        machine_class[i] = class_id;
+        classes[class_id].machines.insert(Key(MachineId_t(i)));
+    }
+    sum = 0.0;
+    sum_of_squares = 0.0;
+    for(unsigned i = 0; i < total_machines; i++) {
+        Update(MachineId_t(i));
+    }
+}
+
+void UtilizationStats::Update(MachineId_t machine_id) {
+    const MachineView_t & view = Machine_GetView(machine_id);
+    float value = (float) view.memory_used / view.memory_size;
+    uint64_t machine_energy;
+    {
+        PROFILE_SCOPE(PROFILE_MACHINE_GET_ENERGY);
+        machine_energy = Machine_GetEnergy(machine_id);
+    }
+    if(value == utilization[machine_id] && machine_energy == energy[machine_id]) {
+        return;
+    }
+    // Re-key the existing set node instead of freeing and allocating a new one
+    set<UtilizationKey_t> & machines = classes[machine_class[machine_id]].machines;
+    auto node = machines.extract(Key(machine_id));
+
+    double old_value = utilization[machine_id];
+    sum += value - old_value;
+    sum_of_squares += double(value) * value - old_value * old_value;
+    utilization[machine_id] = value;
+    energy[machine_id] = machine_energy;
+    node.value() = Key(machine_id);
+    machines.insert(move(node));
+}
+
+float UtilizationStats::StdDevWith(MachineId_t machine_id, float simulated_utilization) const {
+    double n = utilization.size();
+    double current = utilization[machine_id];
+    double simulated = simulated_utilization;
+    double mean = (sum - current + simulated) / n;
+    double variance = (sum_of_squares - current * current + simulated * simulated) / n - mean * mean;
+    return variance > 0.0 ? std::sqrt(variance) : 0.0f;
+}
@@ -0,0 +1,49 @@
+//
+//  UtilizationStats.hpp
+//  CloudSim
+//
+//  Running sums of per-machine memory utilization and the machines grouped into classes of the same CPU
+//  type and memory size. Within a class a task raises every machine's utilization by the same amount, so
+//  the machine that scores the lowest imbalance is the least utilized one, ties broken on energy.
+//
+
+#ifndef UtilizationStats_hpp
+#define UtilizationStats_hpp
+
+#include <set>
+#include <tuple>
+#include <vector>
+
+#include "Interfaces.h"
+#include "MachineView.h"
+
+typedef tuple<float, uint64_t, MachineId_t> UtilizationKey_t;    // (utilization, energy, machine)
+
+typedef struct {
+    CPUType_t cpu;
+    unsigned memory_size;
+    set<UtilizationKey_t> machines;                                 // Ascending utilization, then energy
+} MachineClass_t;
+
+class UtilizationStats {
+public:
+    UtilizationStats()          {}
+    void Init(unsigned total_machines);                                 // Reads every machine once
+    void Update(MachineId_t machine_id);                                // Re-reads one machine from the MachineView after it changed
+    float StdDevWith(MachineId_t machine_id, float simulated_utilization) const;
+
+    const vector<MachineClass_t> & Classes() const              { return classes; }
+    uint64_t Energy(MachineId_t machine_id) const               { return energy[machine_id]; }
+    float Utilization(MachineId_t machine_id) const             { return utilization[machine_id]; }
+private:
+    UtilizationKey_t Key(MachineId_t machine_id) const          { return make_tuple(utilization[machine_id], energy[machine_id], machine_id); }
+
+    vector<float> utilization;                  // memory_used / memory_size as last observed
+    vector<uint64_t> energy;                    // Machine_GetEnergy() as last observed
+    vector<unsigned> machine_class;             // Index into classes
+    vector<MachineClass_t> classes;
+    double sum = 0.0;                           // Sum of utilization over all machines
+    double sum_of_squares = 0.0;                // Sum of utilization^2 over all machines
+};
+
+#endif /* UtilizationStats_hpp */